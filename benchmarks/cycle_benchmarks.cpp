@@ -0,0 +1,266 @@
+#include <benchmark/benchmark.h>
+
+#include <flexcore/scheduler/cyclecontrol.hpp>
+#include <flexcore/scheduler/parallelscheduler.hpp>
+#include <flexcore/scheduler/workstealingscheduler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace fc
+{
+namespace bench
+{
+
+// benchmarks of cycle_control driving many regions.
+// The second argument of the benchmarks is the number of worker threads,
+// 0 selects the parallel_scheduler with one worker per core,
+// other values a work_stealing_scheduler with that many workers.
+
+namespace
+{
+std::unique_ptr<thread::scheduler> make_scheduler(benchmark::State& state, int threads)
+{
+	if (threads == 0)
+	{
+		state.SetLabel("parallel_scheduler");
+		return std::make_unique<thread::parallel_scheduler>();
+	}
+	state.SetLabel("work_stealing_scheduler");
+	return std::make_unique<thread::work_stealing_scheduler>(threads);
+}
+
+/// cycle_control whose loop iterates every tick, with regions doing a little work.
+struct cycle_fixture
+{
+	cycle_fixture(benchmark::State& state, int nr_of_regions, int threads,
+			std::shared_ptr<thread::main_loop> main_loop =
+					std::make_shared<thread::afap_main_loop>(false))
+		: loop(std::move(main_loop))
+		, control(make_scheduler(state, threads),
+				[](auto&){ return true; }, //overruns are part of the measurement
+				loop)
+	{
+		for (int i = 0; i != nr_of_regions; ++i)
+		{
+			regions.push_back(std::make_shared<parallel_region>(
+					"region" + std::to_string(i), thread::cycle_control::fast_tick));
+			regions.back()->work_tick() >> []
+			{
+				int x = 0;
+				for (int j = 0; j != 100; ++j)
+					benchmark::DoNotOptimize(x += j);
+			};
+			control.add_task(thread::periodic_task{regions.back()},
+					thread::cycle_control::fast_tick);
+		}
+	}
+
+	std::shared_ptr<thread::main_loop> loop;
+	thread::cycle_control control;
+	std::vector<std::shared_ptr<parallel_region>> regions;
+};
+
+void regions_and_threads(benchmark::internal::Benchmark* b)
+{
+	for (const int regions : {10, 100, 1000, 10000})
+		for (const int threads : {0, 1, 2, 4, 8})
+			b->Args({regions, threads});
+}
+
+void threads_only(benchmark::internal::Benchmark* b)
+{
+	for (const int threads : {0, 1, 2, 4, 8})
+		b->Args({100, threads});
+}
+}
+
+// cost of a single tick: dispatching all regions and waiting for them to finish.
+void cycle_work(benchmark::State& state)
+{
+	const int nr_of_regions = state.range(0);
+	cycle_fixture fixture{state, nr_of_regions, static_cast<int>(state.range(1))};
+
+	while (state.KeepRunning())
+	{
+		fixture.control.work();
+		fixture.control.stop(); // waits for all tasks of the tick
+	}
+	state.SetItemsProcessed(state.iterations() * nr_of_regions);
+}
+BENCHMARK(cycle_work)->Apply(regions_and_threads)->UseRealTime();
+
+// time between a region being handed to the scheduler and the start of its work tick.
+void dispatch_latency(benchmark::State& state)
+{
+	cycle_fixture fixture{state, static_cast<int>(state.range(0)),
+		static_cast<int>(state.range(1))};
+
+	while (state.KeepRunning())
+	{
+		fixture.control.work();
+		fixture.control.stop();
+	}
+
+	using microseconds = std::chrono::duration<double, std::micro>;
+	double median = 0.0;
+	double worst = 0.0;
+	for (const auto& region : fixture.regions)
+	{
+		const auto& latency =
+				fixture.control.region_statistics(*region).dispatch_latency;
+		median += microseconds(latency.percentile(50.0)).count();
+		worst = std::max(worst, microseconds(latency.percentile(99.0)).count());
+	}
+	state.counters["p50_us"] = median / fixture.regions.size();
+	state.counters["p99_us"] = worst;
+}
+BENCHMARK(dispatch_latency)->Apply(threads_only)->UseRealTime();
+
+// virtual ticks per second of afap_main_loop, with and without skipping idle ticks.
+// A single region with the slow tick is due in every hundredth tick.
+void afap_ticks(benchmark::State& state)
+{
+	const bool skip_idle = state.range(0) != 0;
+	auto loop = std::make_shared<thread::afap_main_loop>(skip_idle);
+	cycle_fixture fixture{state, 0, static_cast<int>(state.range(1)), loop};
+	auto slow = std::make_shared<parallel_region>("slow", thread::cycle_control::slow_tick);
+	fixture.control.add_task(thread::periodic_task{slow}, thread::cycle_control::slow_tick);
+
+	const auto& clock = fixture.control.get_clock();
+	const auto begin = clock.steady_now();
+	const std::function<void(void)> tick = [&fixture]{ fixture.control.work(); };
+	while (state.KeepRunning())
+		loop->loop_body(tick);
+	fixture.control.stop();
+
+	const auto virtual_ticks =
+			(clock.steady_now() - begin) / fixture.control.get_min_tick_length();
+	state.SetItemsProcessed(virtual_ticks);
+}
+BENCHMARK(afap_ticks)->ArgPair(0, 0)->ArgPair(1, 0)->ArgPair(0, 2)->ArgPair(1, 2)
+		->UseRealTime();
+
+namespace
+{
+/// counts hardware cache misses of the calling thread and of the threads it starts afterwards.
+class cache_miss_counter
+{
+public:
+	cache_miss_counter()
+	{
+		perf_event_attr attr{};
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.inherit = 1;
+		fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+	~cache_miss_counter()
+	{
+		if (fd >= 0)
+			close(fd);
+	}
+	cache_miss_counter(const cache_miss_counter&) = delete;
+
+	bool valid() const { return fd >= 0; }
+	/// misses of started threads are only included, once they have exited.
+	uint64_t misses() const
+	{
+		uint64_t count = 0;
+		if (read(fd, &count, sizeof(count)) != sizeof(count))
+			return 0;
+		return count;
+	}
+
+private:
+	int fd;
+};
+
+/// returns the cpus of every numa node.
+std::vector<thread::cpu_set> numa_nodes()
+{
+	std::vector<thread::cpu_set> nodes;
+	try
+	{
+		for (size_t node = 0; ; ++node)
+			nodes.push_back(thread::cpu_set::numa_node(node));
+	}
+	catch (const std::runtime_error&)
+	{
+	}
+	return nodes;
+}
+}
+
+// cache misses per tick of regions, which work on their own data.
+// With argument 1 the regions are pinned to the numa nodes round robin and built there,
+// with 0 they run on unpinned workers and their data is allocated by the main thread.
+// The difference only shows on machines with several numa nodes.
+void numa_cache_misses(benchmark::State& state)
+{
+	const bool local = state.range(0) != 0;
+	const auto nodes = numa_nodes();
+	const auto cpus = thread::cpu_set::single_cpus();
+	cache_miss_counter counter;
+	if (!counter.valid() || nodes.empty() || cpus.empty())
+	{
+		state.SkipWithError("hardware cache counters or numa topology not available");
+		return;
+	}
+
+	// counted threads need to exit before their misses can be read.
+	{
+		auto scheduler = local
+				? std::make_unique<thread::work_stealing_scheduler>(cpus)
+				: std::make_unique<thread::work_stealing_scheduler>(static_cast<int>(cpus.size()));
+		thread::cycle_control control{std::move(scheduler),
+				[](auto&){ return true; }, std::make_shared<thread::afap_main_loop>(false)};
+
+		constexpr size_t data_size = 1 << 18;
+		std::vector<std::shared_ptr<parallel_region>> regions;
+		std::vector<std::vector<int>> data(cpus.size());
+		for (size_t i = 0; i != cpus.size(); ++i)
+		{
+			auto region = std::make_shared<parallel_region>(
+					"region" + std::to_string(i), thread::cycle_control::fast_tick);
+			if (local)
+				region->set_affinity(nodes[i % nodes.size()]);
+			auto& region_data = data[i];
+			region->build_local([&region_data]{ region_data.assign(data_size, 1); });
+			region->work_tick() >> [&region_data]
+			{
+				benchmark::DoNotOptimize(
+						std::accumulate(region_data.begin(), region_data.end(), 0));
+			};
+			control.add_task(thread::periodic_task{region}, thread::cycle_control::fast_tick);
+			regions.push_back(std::move(region));
+		}
+
+		while (state.KeepRunning())
+		{
+			control.work();
+			control.stop();
+		}
+	}
+	state.SetLabel(local ? "local" : "remote");
+	state.counters["misses_per_tick"] =
+			static_cast<double>(counter.misses()) / static_cast<double>(state.iterations());
+}
+BENCHMARK(numa_cache_misses)->Arg(0)->Arg(1)->UseRealTime();
+
+}
+}
@@ -5,7 +5,9 @@
 
 #include "benchmarkfunctions.h"
 
+#include <numeric>
 #include <random>
+#include <vector>
 
 namespace fc
 {
@@ -102,11 +104,245 @@ void extended_node(benchmark::State& state) {
 }
 
 
+// fires events through chains of connections to several sinks.
+// Long chains of connections used to exceed the small buffer of std::function.
+void event_source_chain(benchmark::State& state) {
+	std::random_device rd;
+	std::mt19937 gen(rd());
+
+	float x = gen();
+	float a = 0.0;
+	const float offset = 1.0;
+
+	fc::pure::event_source<float> source;
+	fc::pure::event_sink<float> sink{[&a](float in){ a = in; }};
+	for (int i = 0; i != 4; ++i)
+	{
+		source
+				>> [offset](float in){ return in + offset; }
+				>> [offset](float in){ return in - offset; }
+				>> [](float in){ return in * 1.0f; }
+				>> sink;
+	}
+
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(x);
+
+		source.fire(x);
+
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+// same chains as event_source_chain in a static_event_source, which can inline them.
+void static_event_source_chain(benchmark::State& state) {
+	std::random_device rd;
+	std::mt19937 gen(rd());
+
+	float x = gen();
+	float a = 0.0;
+	const float offset = 1.0;
+
+	fc::pure::event_sink<float> sink{[&a](float in){ a = in; }};
+	const auto chain = [&]
+	{
+		return [offset](float in){ return in + offset; }
+				>> [offset](float in){ return in - offset; }
+				>> [](float in){ return in * 1.0f; }
+				>> sink;
+	};
+	auto source = fc::pure::make_static_event_source<float>(chain(), chain(), chain(), chain());
+
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(x);
+
+		source.fire(x);
+
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+// pulls a state through a chain of connections.
+void state_sink_chain(benchmark::State& state) {
+	std::random_device rd;
+	std::mt19937 gen(rd());
+
+	float x = gen();
+	const float offset = 1.0;
+
+	fc::pure::state_sink<float> sink;
+	[&x](){ return x; }
+			>> [offset](float in){ return in + offset; }
+			>> [offset](float in){ return in - offset; }
+			>> [](float in){ return in * 1.0f; }
+			>> sink;
+
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(x);
+
+		const float a = sink.get();
+
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+// fires a large token to state.range(0) subscribers.
+// A vector is copied for all but the last subscriber, a shared_payload only shares it.
+void fan_out_vector(benchmark::State& state) {
+	const std::vector<float> data(1 << 14, 1.0f);
+	float a = 0.0;
+
+	fc::pure::event_source<std::vector<float>> source;
+	for (int i = 0; i != state.range(0); ++i)
+		source >> [&a](const std::vector<float>& in){ a += in.back(); };
+
+	while (state.KeepRunning()) {
+		source.fire(std::vector<float>(data));
+		benchmark::DoNotOptimize(a);
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) * data.size() * sizeof(float));
+}
+
+void fan_out_shared_payload(benchmark::State& state) {
+	using payload_t = fc::pure::shared_payload<std::vector<float>>;
+	const payload_t data{std::vector<float>(1 << 14, 1.0f)};
+	float a = 0.0;
+
+	fc::pure::event_source<payload_t> source;
+	for (int i = 0; i != state.range(0); ++i)
+		source >> [&a](const payload_t& in){ a += in->back(); };
+
+	while (state.KeepRunning()) {
+		source.fire(data);
+		benchmark::DoNotOptimize(a);
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0) * data->size() * sizeof(float));
+}
+
+// sends state.range(0) buffered events to two sinks one by one.
+void fire_events(benchmark::State& state) {
+	const std::vector<float> events(state.range(0), 1.0f);
+	float a = 0.0;
+
+	fc::pure::event_source<float> source;
+	fc::pure::event_sink<float> sink{[&a](float in){ a += in; }};
+	source >> sink;
+	source >> sink;
+
+	while (state.KeepRunning()) {
+		for (const auto e : events)
+			source.fire(e);
+		benchmark::DoNotOptimize(a);
+	}
+	state.SetItemsProcessed(state.iterations() * events.size());
+}
+
+// same events through a concurrent_event_source, whose connections are read atomically.
+void fire_concurrent_events(benchmark::State& state) {
+	const std::vector<float> events(state.range(0), 1.0f);
+	float a = 0.0;
+
+	fc::pure::concurrent_event_source<float> source;
+	fc::pure::event_sink<float> sink{[&a](float in){ a += in; }};
+	source >> sink;
+	source >> sink;
+
+	while (state.KeepRunning()) {
+		for (const auto e : events)
+			source.fire(e);
+		benchmark::DoNotOptimize(a);
+	}
+	state.SetItemsProcessed(state.iterations() * events.size());
+}
+
+// sends the same events to two sinks, which accept batches.
+void fire_batch_events(benchmark::State& state) {
+	const std::vector<float> events(state.range(0), 1.0f);
+	float a = 0.0;
+
+	fc::pure::event_source<float> source;
+	fc::pure::event_sink<float> sink{[&a](fc::span<const float> in)
+	{
+		for (const auto e : in)
+			a += e;
+	}};
+	source >> sink;
+	source >> sink;
+
+	while (state.KeepRunning()) {
+		source.fire_batch(events);
+		benchmark::DoNotOptimize(a);
+	}
+	state.SetItemsProcessed(state.iterations() * events.size());
+}
+
+// pulls a state derived from an unchanged configuration by an expensive operation.
+void state_recompute(benchmark::State& state) {
+	const std::vector<float> config(1 << 12, 1.0f);
+	fc::pure::state_source<std::vector<float>> source{[&config]{ return config; }};
+	fc::pure::state_sink<float> sink;
+	source >> [](const std::vector<float>& in)
+			{ return std::accumulate(in.begin(), in.end(), 0.0f); }
+			>> sink;
+
+	while (state.KeepRunning()) {
+		const float a = sink.get();
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+// same state with a versioned source and an incremental connection.
+void state_incremental(benchmark::State& state) {
+	using fc::pure::versioned;
+	fc::pure::versioned_state_source<std::vector<float>> source{std::vector<float>(1 << 12, 1.0f)};
+	fc::pure::state_sink<versioned<float>> sink;
+	source >> fc::pure::incremental<std::vector<float>>([](const std::vector<float>& in)
+			{ return std::accumulate(in.begin(), in.end(), 0.0f); })
+			>> sink;
+
+	while (state.KeepRunning()) {
+		const float a = *sink.get();
+		benchmark::DoNotOptimize(a);
+	}
+}
+
+// connects state.range(0) sinks to a tick source, fires once and destroys the sinks again.
+void connect_disconnect_sinks(benchmark::State& state) {
+	const size_t nr_of_sinks = state.range(0);
+	fc::pure::event_source<void> source;
+	int ticks = 0;
+
+	while (state.KeepRunning()) {
+		std::vector<fc::pure::event_sink<void>> sinks;
+		sinks.reserve(nr_of_sinks); // connected sinks must not be moved
+		for (size_t i = 0; i != nr_of_sinks; ++i)
+		{
+			sinks.emplace_back([&ticks]{ ++ticks; });
+			source >> sinks.back();
+		}
+		source.fire();
+		sinks.clear(); // disconnects all sinks
+		benchmark::DoNotOptimize(ticks);
+	}
+	state.SetItemsProcessed(state.iterations() * nr_of_sinks);
+}
 
 BENCHMARK(lambda);
 BENCHMARK(virtual_function);
 BENCHMARK(pure_port);
 BENCHMARK(extended_node);
+BENCHMARK(event_source_chain);
+BENCHMARK(state_sink_chain);
+BENCHMARK(static_event_source_chain);
+BENCHMARK(fan_out_vector)->RangeMultiplier(2)->Range(1, 16);
+BENCHMARK(fan_out_shared_payload)->RangeMultiplier(2)->Range(1, 16);
+BENCHMARK(fire_events)->RangeMultiplier(10)->Range(1, 10000);
+BENCHMARK(fire_concurrent_events)->RangeMultiplier(10)->Range(1, 10000);
+BENCHMARK(fire_batch_events)->RangeMultiplier(10)->Range(1, 10000);
+BENCHMARK(state_recompute);
+BENCHMARK(state_incremental);
+BENCHMARK(connect_disconnect_sinks)->RangeMultiplier(10)->Range(1000, 100000)
+		->Unit(benchmark::kMillisecond);
 
 }
 }
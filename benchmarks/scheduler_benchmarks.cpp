@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <flexcore/scheduler/parallelscheduler.hpp>
+#include <flexcore/scheduler/workstealingscheduler.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace fc
+{
+namespace bench
+{
+
+// benchmarks of the thread pools used to execute the work ticks of regions.
+// Every iteration adds a burst of small tasks, like cycle_control does at the start of a tick,
+// and waits until all of them have been executed.
+
+namespace
+{
+void small_work(std::atomic<int>& done)
+{
+	int x = 0;
+	for (int i = 0; i != 100; ++i)
+		benchmark::DoNotOptimize(x += i);
+	done.fetch_add(1);
+}
+}
+
+template<class scheduler_t>
+void task_burst(benchmark::State& state)
+{
+	const int burst_size = state.range(0);
+	scheduler_t scheduler{};
+	std::atomic<int> done{0};
+
+	while (state.KeepRunning())
+	{
+		done.store(0);
+		for (int i = 0; i != burst_size; ++i)
+			scheduler.add_task([&done]{ small_work(done); });
+		while (done.load() != burst_size)
+			std::this_thread::yield();
+	}
+	state.SetItemsProcessed(state.iterations() * burst_size);
+}
+
+BENCHMARK_TEMPLATE(task_burst, thread::parallel_scheduler)
+		->RangeMultiplier(4)->Range(16, 4096)->UseRealTime();
+BENCHMARK_TEMPLATE(task_burst, thread::work_stealing_scheduler)
+		->RangeMultiplier(4)->Range(16, 4096)->UseRealTime();
+
+// throughput of add_task if several threads add tasks to the same scheduler at once.
+// Every producer adds a batch of tasks per iteration and waits for them to be executed.
+template<class scheduler_t>
+void add_task_producers(benchmark::State& state)
+{
+	// shared by all producer threads of the benchmark, lives until the process exits.
+	static scheduler_t scheduler{};
+	const int batch_size = state.range(0);
+	std::atomic<int> done{0};
+
+	while (state.KeepRunning())
+	{
+		done.store(0);
+		for (int i = 0; i != batch_size; ++i)
+			scheduler.add_task([&done]{ done.fetch_add(1); });
+		while (done.load() != batch_size)
+			std::this_thread::yield();
+	}
+	state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+BENCHMARK_TEMPLATE(add_task_producers, thread::parallel_scheduler)
+		->Arg(64)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(add_task_producers, thread::work_stealing_scheduler)
+		->Arg(64)->ThreadRange(1, 16)->UseRealTime();
+
+}
+}
@@ -0,0 +1,219 @@
+#ifndef SRC_CORE_DETAIL_INLINE_FUNCTION_HPP_
+#define SRC_CORE_DETAIL_INLINE_FUNCTION_HPP_
+
+#include <flexcore/core/traits.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace fc
+{
+namespace detail
+{
+
+template<class fun_t, class signature_t, class enable = void>
+struct is_callable_as : std::false_type {};
+
+template<class fun_t, class result_t, class... args_t>
+struct is_callable_as<fun_t, result_t(args_t...),
+		always_void<decltype(std::declval<fun_t&>()(std::declval<args_t>()...))>>
+	: std::integral_constant<bool, std::is_void<result_t>{} || std::is_convertible<
+			decltype(std::declval<fun_t&>()(std::declval<args_t>()...)), result_t>{}>
+{
+};
+
+template<class signature_t, size_t capacity>
+class inline_function;
+
+/**
+ * \brief Move only replacement for std::function with a fixed size of inline storage.
+ *
+ * Callables which fit into capacity bytes and are nothrow move constructible
+ * are stored inside the object itself, thus construction and moves do not allocate.
+ * Larger callables are stored on the heap.
+ * Since inline_function is move only, callables do not need to be copy constructible.
+ * The call operator is stored next to the callable, thus calls cost a single indirect call.
+ *
+ * \tparam result_t return type of the stored callable.
+ * \tparam args_t parameter types of the stored callable.
+ * \tparam capacity size of the inline storage in bytes.
+ */
+template<class result_t, class... args_t, size_t capacity>
+class inline_function<result_t(args_t...), capacity>
+{
+	static constexpr size_t buffer_size = capacity < sizeof(void*) ? sizeof(void*) : capacity;
+	using storage_t = std::aligned_storage_t<buffer_size, alignof(std::max_align_t)>;
+
+public:
+	/// returns true if callables of type fun_t are stored without allocation.
+	template<class fun_t>
+	static constexpr bool stores_inline()
+	{
+		return sizeof(fun_t) <= buffer_size
+				&& alignof(std::max_align_t) % alignof(fun_t) == 0
+				&& std::is_nothrow_move_constructible<fun_t>{};
+	}
+
+	inline_function() noexcept = default;
+	inline_function(std::nullptr_t) noexcept {}
+
+	/// \post *this contains f
+	template<class fun_t, class = std::enable_if_t<
+			!std::is_same<std::decay_t<fun_t>, inline_function>{}
+			&& is_callable_as<std::decay_t<fun_t>, result_t(args_t...)>{}>>
+	inline_function(fun_t&& f)
+	{
+		using stored_t = std::decay_t<fun_t>;
+		construct<stored_t>(std::forward<fun_t>(f),
+				std::integral_constant<bool, stores_inline<stored_t>()>{});
+	}
+
+	/// \post o is empty
+	inline_function(inline_function&& o) noexcept
+	{
+		take(o);
+	}
+
+	/// \post o is empty
+	inline_function& operator=(inline_function&& o) noexcept
+	{
+		if (this != &o)
+		{
+			reset();
+			take(o);
+		}
+		return *this;
+	}
+
+	inline_function& operator=(std::nullptr_t) noexcept
+	{
+		reset();
+		return *this;
+	}
+
+	inline_function(const inline_function&) = delete;
+	inline_function& operator=(const inline_function&) = delete;
+
+	~inline_function() { reset(); }
+
+	/// returns true if a callable is stored.
+	explicit operator bool() const noexcept { return operations != nullptr; }
+
+	/**
+	 * \brief calls the stored callable
+	 * \pre *this is not empty
+	 */
+	result_t operator()(args_t... args) const
+	{
+		assert(operations);
+		return invoker(const_cast<storage_t*>(&storage), std::forward<args_t>(args)...);
+	}
+
+	friend void swap(inline_function& lhs, inline_function& rhs) noexcept
+	{
+		inline_function tmp{std::move(lhs)};
+		lhs = std::move(rhs);
+		rhs = std::move(tmp);
+	}
+
+private:
+	using invoke_t = result_t (*)(void*, args_t&&...);
+
+	/// type erased operations on the stored callable.
+	struct operations_t
+	{
+		invoke_t invoke;
+		/// move constructs callable in "to" and destroys callable in "from".
+		void (*move)(void* from, void* to);
+		void (*destroy)(void*);
+	};
+
+	template<class fun_t>
+	struct inline_operations
+	{
+		static result_t invoke(void* s, args_t&&... args)
+		{
+			return (*static_cast<fun_t*>(s))(std::forward<args_t>(args)...);
+		}
+		static void move(void* from, void* to)
+		{
+			new (to) fun_t(std::move(*static_cast<fun_t*>(from)));
+			static_cast<fun_t*>(from)->~fun_t();
+		}
+		static void destroy(void* s) { static_cast<fun_t*>(s)->~fun_t(); }
+		static const operations_t* get()
+		{
+			static const operations_t table{&invoke, &move, &destroy};
+			return &table;
+		}
+	};
+
+	template<class fun_t>
+	struct heap_operations
+	{
+		static fun_t*& target(void* s) { return *static_cast<fun_t**>(s); }
+		static result_t invoke(void* s, args_t&&... args)
+		{
+			return (*target(s))(std::forward<args_t>(args)...);
+		}
+		static void move(void* from, void* to)
+		{
+			new (to) fun_t*(target(from));
+		}
+		static void destroy(void* s) { delete target(s); }
+		static const operations_t* get()
+		{
+			static const operations_t table{&invoke, &move, &destroy};
+			return &table;
+		}
+	};
+
+	template<class fun_t, class arg_t>
+	void construct(arg_t&& f, std::true_type /*inline*/)
+	{
+		new (&storage) fun_t(std::forward<arg_t>(f));
+		operations = inline_operations<fun_t>::get();
+		invoker = operations->invoke;
+	}
+
+	template<class fun_t, class arg_t>
+	void construct(arg_t&& f, std::false_type /*inline*/)
+	{
+		new (&storage) fun_t*(new fun_t(std::forward<arg_t>(f)));
+		operations = heap_operations<fun_t>::get();
+		invoker = operations->invoke;
+	}
+
+	/// \pre *this is empty
+	void take(inline_function& o) noexcept
+	{
+		assert(!operations);
+		if (!o.operations)
+			return;
+		o.operations->move(&o.storage, &storage);
+		operations = o.operations;
+		invoker = o.invoker;
+		o.operations = nullptr;
+	}
+
+	void reset() noexcept
+	{
+		if (!operations)
+			return;
+		operations->destroy(&storage);
+		operations = nullptr;
+	}
+
+	storage_t storage;
+	const operations_t* operations = nullptr;
+	/// copy of operations->invoke, valid if operations is not nullptr.
+	invoke_t invoker = nullptr;
+};
+
+} // namespace detail
+} // namespace fc
+
+#endif /* SRC_CORE_DETAIL_INLINE_FUNCTION_HPP_ */
@@ -0,0 +1,72 @@
+#ifndef SRC_CORE_SPAN_HPP_
+#define SRC_CORE_SPAN_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace fc
+{
+
+/**
+ * \brief non-owning view of contiguous elements, like std::span of C++20.
+ *
+ * Used to pass batches of tokens through ports without copying them.
+ * \tparam T type of the elements, const T for read only access.
+ */
+template<class T>
+class span
+{
+public:
+	using element_type = T;
+	using value_type = std::remove_cv_t<T>;
+	using iterator = T*;
+	using reference = T&;
+
+	constexpr span() noexcept = default;
+	constexpr span(T* first, size_t count) noexcept
+		: first(first)
+		, count(count)
+	{
+	}
+
+	/// views the elements of a contiguous container, like std::vector or std::array.
+	template<class container_t, class = std::enable_if_t<
+			!std::is_same<std::decay_t<container_t>, span>{}
+			&& std::is_convertible<decltype(std::declval<container_t&>().data()), T*>{}>>
+	constexpr span(container_t& container) noexcept
+		: first(container.data())
+		, count(container.size())
+	{
+	}
+
+	/// span<T> converts to span<const T>.
+	template<class U, class = std::enable_if_t<std::is_convertible<U(*)[], T(*)[]>{}>>
+	constexpr span(const span<U>& other) noexcept
+		: first(other.data())
+		, count(other.size())
+	{
+	}
+
+	constexpr T* data() const noexcept { return first; }
+	constexpr size_t size() const noexcept { return count; }
+	constexpr bool empty() const noexcept { return count == 0; }
+
+	constexpr iterator begin() const noexcept { return first; }
+	constexpr iterator end() const noexcept { return first + count; }
+
+	reference operator[](size_t index) const
+	{
+		assert(index < count);
+		return first[index];
+	}
+
+private:
+	T* first = nullptr;
+	size_t count = 0;
+};
+
+} // namespace fc
+
+#endif /* SRC_CORE_SPAN_HPP_ */
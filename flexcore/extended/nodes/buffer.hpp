@@ -2,6 +2,7 @@
 #define SRC_NODES_BUFFER_HPP_
 
 #include <flexcore/core/traits.hpp>
+#include <flexcore/core/span.hpp>
 
 #include <boost/circular_buffer.hpp>
 #include <vector>
@@ -135,6 +136,10 @@ struct collector
 {
 	// result_t is defined to allow result_of trait with overloaded operator().
 	using result_t = void;
+	/// batches sent by event_source::fire_batch are inserted at once.
+	using batch_t = span<const data_t>;
+
+	bool accepts_batches() const noexcept { return true; }
 
 	template <class range_t>
 	void operator()(const range_t& range)
@@ -0,0 +1,84 @@
+#ifndef SRC_NODES_RECORDING_HPP_
+#define SRC_NODES_RECORDING_HPP_
+
+#include <flexcore/extended/nodes/event_nodes.hpp>
+#include <flexcore/pure/pure_node.hpp>
+#include <flexcore/scheduler/clock.hpp>
+#include <flexcore/scheduler/replay.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+namespace fc
+{
+
+/**
+ * \brief forwards events and records them with the current virtual time in an event_log.
+ *
+ * Place recording_taps between sources outside of the graph and the graph,
+ * to replay the inputs of a run with thread::replay_main_loop.
+ *
+ * \tparam event_t type of event recorded, stored as raw bytes.
+ * \ingroup nodes
+ */
+template<class event_t, class base_t = pure::pure_node>
+class recording_tap : public generic_event_node<event_t, event_t, base_t>
+{
+	static_assert(std::is_trivially_copyable<event_t>::value,
+			"recorded events are stored as raw bytes, thus need to be trivially copyable");
+public:
+	/**
+	 * \param log log the events are recorded in, needs to outlive the tap.
+	 * \param channel identifies the tap in the log, needs to be unique per log.
+	 * \param clock clock of the events, usually the clock of the receiving region.
+	 */
+	template<class... base_args>
+	recording_tap(event_log& log, event_log::channel_t channel,
+			const virtual_clock::instance& clock, base_args&&... args)
+		: generic_event_node<event_t, event_t, base_t>(
+				[this](const event_t& in)
+				{
+					this->log.record(this->clock.steady_now(), this->channel, &in, sizeof(in));
+					this->out_port.fire(in);
+				},
+				std::forward<base_args>(args)...)
+		, log(log)
+		, channel(channel)
+		, clock(clock)
+	{
+	}
+
+	/// returns the channel the tap records in.
+	event_log::channel_t get_channel() const { return channel; }
+
+	/**
+	 * \brief fires a recorded event at out without recording it again.
+	 * \pre size == sizeof(event_t)
+	 */
+	void replay(const char* data, size_t size)
+	{
+		assert(size == sizeof(event_t));
+		(void)size;
+		event_t event;
+		std::memcpy(&event, data, sizeof(event));
+		this->out_port.fire(event);
+	}
+
+private:
+	event_log& log;
+	const event_log::channel_t channel;
+	const virtual_clock::instance& clock;
+};
+
+/// registers tap as injector for its channel at loop.
+template<class event_t, class base_t>
+void replay_channel(thread::replay_main_loop& loop, recording_tap<event_t, base_t>& tap)
+{
+	loop.add_channel(tap.get_channel(),
+			[&tap](const char* data, size_t size){ tap.replay(data, size); });
+}
+
+} // namespace fc
+
+#endif /* SRC_NODES_RECORDING_HPP_ */
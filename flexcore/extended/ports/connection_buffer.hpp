@@ -3,9 +3,11 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include <flexcore/pure/pure_ports.hpp>
 #include <flexcore/extended/ports/token_tags.hpp>
+#include <flexcore/utils/tracing/tracing.hpp>
 
 namespace fc
 {
@@ -85,7 +87,7 @@ public:
 		, switch_passive_tick_([this] { switch_passive_buffers(); })
 		, switch_active_passive_tick_([this] { switch_active_passive_buffers(); })
 		, in_send_tick( [this](){ send_events(); } )
-		, in_event_port( [this](event_t in_event) { intern_buffer.push_back(in_event);})
+		, in_event_port( [this](event_t in_event) { intern_buffer.push_back(std::move(in_event));})
 		, intern_buffer()
 		, extern_buffer()
 		, read(false)
@@ -107,6 +109,14 @@ public:
 	in_port_t& in() override { return in_event_port; }
 	out_port_t& out() override { return out_event_port; }
 
+	/// reserves storage for capacity events in all buffers, switching keeps the capacity.
+	void reserve(size_t capacity)
+	{
+		intern_buffer.reserve(capacity);
+		middle_buffer.reserve(capacity);
+		extern_buffer.reserve(capacity);
+	}
+
 private:
 	/**
 	 * \brief switches intern_buffer to middle_buffer
@@ -168,8 +178,9 @@ private:
 	 */
 	void send_events()
 	{
-		for (event_t e : extern_buffer)
-			out_event_port.fire(e);
+		FC_TRACE_SPAN("send_events", "buffer");
+		// events are not read again, thus they are moved to the last connection of the port.
+		out_event_port.fire_batch(span<event_t>(extern_buffer));
 
 		// delete content of extern buffer, do not change capacity,
 		// since we want to avoid allocations in next cycle.
@@ -228,6 +239,9 @@ public:
 	in_port_t& in() override { return in_event_port; }
 	out_port_t& out() override { return out_event_port; }
 
+	/// void events are only counted, thus nothing needs to be reserved.
+	void reserve(size_t) {}
+
 private:
 	void switch_active_buffers()
 	{
@@ -261,8 +275,8 @@ private:
 	 */
 	void send_events()
 	{
-		for (size_t i = 0; i < extern_buffer; ++i)
-			out_event_port.fire();
+		FC_TRACE_SPAN("send_events", "buffer");
+		out_event_port.fire_batch(extern_buffer);
 
 		extern_buffer = 0;
 	}
@@ -391,6 +405,16 @@ struct buffer<data_t, state_tag>
 {
 	using type = state_buffer<data_t>;
 };
+
+/// states are stored by value, thus state buffers have nothing to reserve.
+template<class data_t>
+void reserve_buffer(state_buffer<data_t>&, size_t) {}
+
+template<class event_t>
+void reserve_buffer(event_buffer<event_t>& buffer, size_t capacity)
+{
+	buffer.reserve(capacity);
+}
 }
 
 } // namespace fc
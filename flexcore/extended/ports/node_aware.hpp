@@ -5,9 +5,14 @@
 #include <flexcore/core/connection_util.hpp>
 #include <flexcore/core/connection.hpp>
 #include <flexcore/extended/ports/connection_buffer.hpp>
+#include <flexcore/pure/concurrent_event_source.hpp>
 #include <flexcore/scheduler/parallelregion.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <stdexcept>
 
 namespace fc
 {
@@ -33,6 +38,17 @@ bool same_tick_rate(const node_aware<source_t>& source,
 	return source.region().get_duration() == sink.region().get_duration();
 }
 
+/**
+ * \brief checks if the ticks of two node_aware's regions have the same phase offset
+ * \pre same_region(source, sink) == true;
+ */
+template<class source_t, class sink_t>
+bool same_phase(const node_aware<source_t>& source,
+        const node_aware<sink_t>& sink)
+{
+	return source.region().get_phase() == sink.region().get_phase();
+}
+
 ///factory to construct a buffer depending on region and token_type
 template<class token_t>
 struct buffer_factory
@@ -52,10 +68,18 @@ struct buffer_factory
 		{
 			auto result_buffer =
 					std::make_shared<typename detail::buffer<token_t, tag>::type>();
+			detail::reserve_buffer(*result_buffer, std::max(
+					active.region().get_buffer_capacity(),
+					passive.region().get_buffer_capacity()));
 
-			if(same_tick_rate(active, passive))
+			if(same_tick_rate(active, passive) && same_phase(active, passive))
 			{
-				active.region().switch_tick() >> result_buffer->switch_active_passive_tick();
+				// switched with the active region, unless the receiving region
+				// is started after the sending region in the same tick.
+				// see thread::cycle_control::set_region_dependencies
+				active.region().ticks.link(sending_region(active, passive, tag{}),
+						receiving_region(active, passive, tag{})).switch_tick
+						>> result_buffer->switch_active_passive_tick();
 			}
 			else
 			{
@@ -69,6 +93,35 @@ struct buffer_factory
 		else
 			return std::make_shared<typename detail::no_buffer<token_t, tag>::type>();
 	}
+
+private:
+	/// events are sent by the active source
+	template<class active_t, class passive_t>
+	static parallel_region& sending_region(const active_t& active, const passive_t&, event_tag)
+	{
+		return active.region();
+	}
+
+	/// states are sent by the passive source
+	template<class active_t, class passive_t>
+	static parallel_region& sending_region(const active_t&, const passive_t& passive, state_tag)
+	{
+		return passive.region();
+	}
+
+	/// events are received by the passive sink
+	template<class active_t, class passive_t>
+	static parallel_region& receiving_region(const active_t&, const passive_t& passive, event_tag)
+	{
+		return passive.region();
+	}
+
+	/// states are received by the active sink
+	template<class active_t, class passive_t>
+	static parallel_region& receiving_region(const active_t& active, const passive_t&, state_tag)
+	{
+		return active.region();
+	}
 };
 
 /**
@@ -142,9 +195,43 @@ struct result_of<node_aware<connection<source_t, sink_t>>>
 	using type = result_of_t<source_t>;
 };
 
+/**
+ * \brief ports, whose connections change while their region runs.
+ *
+ * Buffers between regions are switched by the tick sources of the regions,
+ * which cannot be connected while the scheduler runs.
+ * Thus these ports are only connected within their own region, without buffer.
+ */
+template<class T> struct connects_at_runtime : std::false_type {};
+template<class T>
+struct connects_at_runtime<pure::concurrent_event_source<T>> : std::true_type {};
+
 namespace detail
 {
 
+/**
+ * \brief connects ports, which need to reclaim memory, to the reclaim tick of the region.
+ * The reclaim tick may be connected while the region runs, thus ports can be created at runtime.
+ */
+template<class port_t>
+auto attach_to_region(port_t& port, parallel_region& region, int)
+	-> decltype(static_cast<void>(port.reclaim_tick()))
+{
+	region.reclaim_tick() >> port.reclaim_tick();
+}
+template<class port_t>
+void attach_to_region(port_t&, parallel_region&, long)
+{
+}
+
+/// true if port_t needs the tick generation of the region in front of args.
+template<class port_t, class... args>
+struct needs_generation : std::integral_constant<bool,
+		std::is_constructible<port_t, const std::atomic<uint64_t>&, args...>{}
+		&& !std::is_constructible<port_t, args...>{}>
+{
+};
+
 /**
  * \brief creates buffered_connection for events
  * \param buffer the buffer used for the connection
@@ -212,10 +299,15 @@ struct node_aware: base
 	//allows explicit access to base of this mixin.
 	using base_t = base ;
 
-	///Constructor takes a reference to the region and forwards all other args.
+	/**
+	 * \brief Constructor takes a reference to the region and forwards all other args.
+	 * Ports which can only be constructed with a tick generation in front of args,
+	 * like pure::memoizing_state_source, get the generation of the region.
+	 */
 	template <class ... args>
 	node_aware(parallel_region& r, args&&... base_constructor_args)
-		: base(std::forward<args>(base_constructor_args)...), region_(r)
+		: node_aware(detail::needs_generation<base, args...>{},
+				r, std::forward<args>(base_constructor_args)...)
 	{
 	}
 
@@ -241,13 +333,43 @@ private:
 
 	std::reference_wrapper<parallel_region> region_;
 
+	template <class ... args>
+	node_aware(std::true_type, parallel_region& r, args&&... base_constructor_args)
+		: base(r.ticks.generation(), std::forward<args>(base_constructor_args)...), region_(r)
+	{
+		detail::attach_to_region(static_cast<base&>(*this), r, 0);
+	}
+	template <class ... args>
+	node_aware(std::false_type, parallel_region& r, args&&... base_constructor_args)
+		: base(std::forward<args>(base_constructor_args)...), region_(r)
+	{
+		detail::attach_to_region(static_cast<base&>(*this), r, 0);
+	}
+
 	template <class conn_t>
 	auto connect_impl(conn_t&& conn, connection_has_node_aware)
+	{
+		return connect_impl(std::forward<conn_t>(conn), connection_has_node_aware{},
+				connects_at_runtime<base>{});
+	}
+
+	template <class conn_t>
+	auto connect_impl(conn_t&& conn, connection_has_node_aware, std::false_type)
 	{
 		return base::connect(
 		    introduce_buffer(std::forward<conn_t>(conn), is_active_source<base>{}));
 	}
 
+	/// connects without buffer, thus the sink can be disconnected from the port.
+	template <class conn_t>
+	auto connect_impl(conn_t&& conn, connection_has_node_aware, std::true_type)
+	{
+		if (!same_region(*this, get_sink(conn)))
+			throw std::invalid_argument{"ports connected at runtime can only be connected "
+					"to sinks in their own region."};
+		return base::connect(std::forward<conn_t>(conn));
+	}
+
 	template <class conn_t>
 	auto connect_impl(conn_t&& conn, connection_doesnt_have_node_aware)
 	{
@@ -2,6 +2,11 @@
 #include <flexcore/scheduler/parallelscheduler.hpp>
 #include <memory>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
 
 namespace fc
 {
@@ -10,8 +15,9 @@ class scheduled_region : public fc::parallel_region
 {
 public:
 	scheduled_region(std::string name, virtual_clock::steady::duration tick_rate,
-			std::weak_ptr<region_factory> region_maker)
-		: parallel_region(std::move(name), tick_rate), region_maker(std::move(region_maker))
+			virtual_clock::steady::duration phase, std::weak_ptr<region_factory> region_maker)
+		: parallel_region(std::move(name), tick_rate, phase)
+		, region_maker(std::move(region_maker))
 	{
 	}
 	std::shared_ptr<parallel_region>
@@ -32,7 +38,8 @@ public:
 
 	/// Creates a new region and connects it to the scheduler with a periodic task.
 	std::shared_ptr<parallel_region> new_region(const std::string& name,
-	                                            const virtual_clock::steady::duration& tick_rate);
+	                                            const virtual_clock::steady::duration& tick_rate,
+	                                            const virtual_clock::steady::duration& phase);
 
 private:
 	thread::cycle_control& scheduler;
@@ -42,31 +49,106 @@ std::shared_ptr<parallel_region>
 scheduled_region::new_region(std::string name, virtual_clock::steady::duration tick_rate) const
 {
 	if (auto factory = region_maker.lock())
-		return factory->new_region(std::move(name), tick_rate);
+		return factory->new_region(std::move(name), tick_rate,
+				virtual_clock::steady::duration::zero());
 	else
 		throw std::runtime_error{"Region factory has been destroyed already"};
 }
 
 std::shared_ptr<parallel_region>
 region_factory::new_region(const std::string& name,
-                           const virtual_clock::steady::duration& tick_rate)
+                           const virtual_clock::steady::duration& tick_rate,
+                           const virtual_clock::steady::duration& phase)
 {
-	auto region = std::make_shared<scheduled_region>(name, tick_rate, shared_from_this());
+	auto region = std::make_shared<scheduled_region>(name, tick_rate, phase, shared_from_this());
 	auto tick_cycle = fc::thread::periodic_task(region);
-	scheduler.add_task(std::move(tick_cycle),tick_rate);
+	scheduler.add_task(std::move(tick_cycle), tick_rate, phase);
 	return region;
 }
+
+/**
+ * \brief collects the dependencies between regions from the connections in the graph.
+ * Connectables without a region, like lambdas between ports, are looked through.
+ */
+std::vector<thread::region_dependency> region_dependencies(const graph::connection_graph& graph)
+{
+	using node_t = graph::graph_node_properties;
+	using id_hash = boost::hash<graph::unique_id>;
+
+	std::unordered_map<graph::unique_id, std::vector<const node_t*>, id_hash> successors;
+	for (const auto& edge : graph.edges())
+		successors[edge.source.node_properties.get_id()].push_back(&edge.sink.node_properties);
+
+	std::vector<thread::region_dependency> dependencies;
+	std::vector<const node_t*> open_nodes;
+	std::unordered_set<graph::unique_id, id_hash> visited;
+	for (const auto& edge : graph.edges())
+	{
+		const parallel_region* producer = edge.source.node_properties.region();
+		if (!producer)
+			continue;
+
+		open_nodes.assign(1, &edge.sink.node_properties);
+		visited.clear();
+		while (!open_nodes.empty())
+		{
+			const node_t* node = open_nodes.back();
+			open_nodes.pop_back();
+			if (!visited.insert(node->get_id()).second)
+				continue;
+
+			if (const parallel_region* consumer = node->region())
+			{
+				if (consumer != producer)
+					dependencies.push_back(thread::region_dependency{producer, consumer});
+				continue;
+			}
+			const auto next = successors.find(node->get_id());
+			if (next != successors.end())
+				open_nodes.insert(open_nodes.end(), next->second.begin(), next->second.end());
+		}
+	}
+	return dependencies;
+}
 } // namespace detail
 
+void infrastructure::use_region_dependencies()
+{
+	scheduler.set_region_dependencies(detail::region_dependencies(graph));
+}
+
 std::shared_ptr<parallel_region>
 infrastructure::add_region(const std::string& name,
                            const virtual_clock::steady::duration& tick_rate)
 {
-	return region_maker->new_region(name, tick_rate);
+	return region_maker->new_region(name, tick_rate, virtual_clock::steady::duration::zero());
+}
+
+std::shared_ptr<parallel_region>
+infrastructure::add_region(const std::string& name,
+                           const virtual_clock::steady::duration& tick_rate,
+                           const region_options& options)
+{
+	auto region = region_maker->new_region(name, tick_rate, options.phase);
+	region->set_affinity(options.cpus);
+	region->set_overrun_policy(options.overrun);
+	return region;
+}
+
+std::shared_ptr<parallel_region>
+infrastructure::add_balanced_region(const std::string& name,
+                                    const virtual_clock::steady::duration& tick_rate)
+{
+	return region_maker->new_region(name, tick_rate, scheduler.least_loaded_phase(tick_rate));
 }
 
 infrastructure::infrastructure()
-    : scheduler(std::make_unique<fc::thread::parallel_scheduler>())
+    : infrastructure(std::make_unique<fc::thread::parallel_scheduler>())
+{
+}
+
+infrastructure::infrastructure(std::unique_ptr<thread::scheduler> scheduler_)
+    : scheduler(std::move(scheduler_))
     , region_maker(std::make_shared<detail::region_factory>(scheduler))
     , graph()
     , forest_root(graph, "root", add_region("root_region", thread::cycle_control::medium_tick))
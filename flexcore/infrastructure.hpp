@@ -10,15 +10,107 @@ namespace detail {
 class region_factory;
 }
 
+/// optional properties of regions, \see infrastructure::add_region
+struct region_options
+{
+	/// offset of the ticks relative to multiples of the tick rate.
+	virtual_clock::steady::duration phase = virtual_clock::steady::duration::zero();
+	/**
+	 * \brief cpus the tasks of the region run on, empty if they may run anywhere.
+	 * Requires a scheduler supporting affinity, e.g. a work_stealing_scheduler
+	 * with workers pinned to these cpus, \see parallel_region::set_affinity
+	 * and parallel_region::build_local to place the nodes of the region on their numa node.
+	 */
+	thread::cpu_set cpus{};
+	/// reaction to ticks which overrun, \see parallel_region::set_overrun_policy
+	thread::overrun_policy overrun{};
+};
+
 class infrastructure
 {
 public:
+	/// constructs infrastructure which executes its regions with a parallel_scheduler.
 	infrastructure();
+	/**
+	 * \brief constructs infrastructure which executes its regions with the given scheduler.
+	 * \pre scheduler != nullptr
+	 * \see work_stealing_scheduler for an alternative to the default parallel_scheduler.
+	 */
+	explicit infrastructure(std::unique_ptr<thread::scheduler> scheduler);
 	~infrastructure();
 
 	std::shared_ptr<parallel_region> add_region(const std::string& name,
 			const virtual_clock::steady::duration& tick_rate);
 
+	/**
+	 * \brief adds a region with the given phase, cpus and overrun policy.
+	 * \pre options.phase is a multiple of the min tick length in [0, tick_rate)
+	 */
+	std::shared_ptr<parallel_region> add_region(const std::string& name,
+			const virtual_clock::steady::duration& tick_rate,
+			const region_options& options);
+
+	/**
+	 * \brief adds a region with the phase which keeps the number of regions per tick lowest.
+	 * \see thread::cycle_control::least_loaded_phase
+	 */
+	std::shared_ptr<parallel_region> add_balanced_region(const std::string& name,
+			const virtual_clock::steady::duration& tick_rate);
+
+	/// returns the number of regions due in each tick, \see thread::cycle_control::slot_load
+	std::vector<size_t> slot_load() const { return scheduler.slot_load(); }
+
+	/**
+	 * \brief sets the duration of a single tick of the scheduler.
+	 * All regions, including the root region with medium_tick,
+	 * need to have tick rates which are multiples of length.
+	 * \see thread::cycle_control::set_min_tick_length
+	 */
+	void set_min_tick_length(virtual_clock::steady::duration length)
+	{
+		scheduler.set_min_tick_length(length);
+	}
+
+	/**
+	 * \brief returns the timing of the work ticks of region.
+	 * \see thread::cycle_control::region_statistics
+	 */
+	const thread::task_statistics& region_statistics(const parallel_region& region) const
+	{
+		return scheduler.region_statistics(region);
+	}
+
+	/**
+	 * \brief returns the counters of the overruns of region.
+	 * \see thread::cycle_control::region_overruns
+	 */
+	const thread::overrun_counters& region_overruns(const parallel_region& region) const
+	{
+		return scheduler.region_overruns(region);
+	}
+
+	/// returns the virtual clock of the regions of this infrastructure.
+	const virtual_clock::instance& get_clock() const { return scheduler.get_clock(); }
+
+	/**
+	 * \brief sets real-time priorities and memory locking, applied by start_scheduler.
+	 * \see thread::cycle_control::set_realtime_settings
+	 * \pre scheduler is not running
+	 */
+	void set_realtime_settings(const thread::realtime_settings& settings)
+	{
+		scheduler.set_realtime_settings(settings);
+	}
+
+	/**
+	 * \brief starts connected regions with the same tick rate one after the other.
+	 * Reads the connections between regions from the graph,
+	 * thus needs to be called again after new connections have been made.
+	 * \see thread::cycle_control::set_region_dependencies
+	 * \pre scheduler is not running
+	 */
+	void use_region_dependencies();
+
 	owning_base_node& node_owner() { return forest_root.nodes(); }
 	graph::connection_graph& get_graph() { return graph; }
 	void visualize(std::ostream& out) { forest_root.visualize(out); }
@@ -58,6 +58,15 @@ using event_sink = default_mixin<pure::event_sink<data_t>>;
 template<class data_t>
 using event_source = default_mixin<pure::event_source<data_t>>;
 
+/**
+ * \brief event_source, whose connections can change while its region fires it.
+ * Connects reclaim_tick to the reclaim tick of its region on construction.
+ * Runtime connections are direct, thus only sinks in the same region can be connected.
+ * \ingroup ports
+ */
+template<class data_t>
+using concurrent_event_source = default_mixin<pure::concurrent_event_source<data_t>>;
+
 /**
  * \brief Default state_sink port
  * \ingroup ports
@@ -72,6 +81,14 @@ using state_sink = default_mixin<pure::state_sink<data_t>>;
 template<class data_t>
 using state_source = default_mixin<pure::state_source<data_t>>;
 
+/**
+ * \brief state_source, which calls its function at most once per tick of its region.
+ * Binds the generation of its region, thus it is constructed with the function only.
+ * \ingroup ports
+ */
+template<class data_t>
+using memoizing_state_source = default_mixin<pure::memoizing_state_source<data_t>>;
+
 // -- dispatch --
 
 /// template input port, tag object creates either event_sink or state_sink
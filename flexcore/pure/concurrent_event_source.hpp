@@ -0,0 +1,176 @@
+#ifndef SRC_PORTS_CONCURRENT_EVENT_SOURCE_HPP_
+#define SRC_PORTS_CONCURRENT_EVENT_SOURCE_HPP_
+
+#include <flexcore/core/traits.hpp>
+#include <flexcore/core/connection_util.hpp>
+#include <flexcore/pure/detail/active_connection_proxy.hpp>
+#include <flexcore/pure/detail/port_traits.hpp>
+#include <flexcore/pure/detail/port_utils.hpp>
+#include <flexcore/pure/event_sinks.hpp>
+#include <flexcore/pure/port_connection.hpp>
+
+#include <atomic>
+#include <functional>
+#include <utility>
+
+namespace fc
+{
+namespace pure
+{
+
+/**
+ * \brief Output port for events, whose connections can change while it fires.
+ *
+ * In contrast to event_source, connect and disconnect may be called from any thread,
+ * while the port fires in its region, for instance to add modules at runtime.
+ * fire never blocks, it reads the connections through a single atomic load.
+ * Changes are published atomically, thus a call of fire sends to either
+ * all connections before or all connections after a change.
+ *
+ * Each change replaces the list of connections, the replaced lists are freed by reclaim.
+ * Until reclaim_tick is requested, connect and disconnect reclaim right away,
+ * thus they must not run concurrently to fire.
+ * For concurrent changes, connect reclaim_tick to the reclaim tick of the region firing the port,
+ * the node aware fc::concurrent_event_source does so on construction:
+ * \code{cpp}
+ * region->reclaim_tick() >> source.reclaim_tick();
+ * \endcode
+ *
+ * \pre fire is only called in ticks of a single region and never during reclaim.
+ * \pre sinks are disconnected before they are destroyed,
+ * and destroyed after the next reclaim, as a running fire may still reach them.
+ *
+ * \tparam event_t type of event sent by the port.
+ * \ingroup ports
+ */
+template<class event_t>
+class concurrent_event_source
+{
+public:
+	using result_t = std::remove_reference_t<event_t>;
+	using token_t = event_t;
+
+	concurrent_event_source() = default;
+	/// connections of reclaim_tick are not moved, connect it again after the move.
+	concurrent_event_source(concurrent_event_source&& other)
+		: base(std::move(other.base))
+		, reclaim_on_change(other.reclaim_on_change.load())
+	{
+	}
+
+	/**
+	 * \brief Sends parameter as event to all connections.
+	 *
+	 * As event_source, the last connection receives event itself, the others a copy.
+	 * \param event token to be sent through this port.
+	 */
+	template<class... T>
+	void fire(T&&... event)
+	{
+		static_assert(sizeof...(T) == 0 || sizeof...(T) == 1,
+				"we only allow single events, or void events atm");
+
+		static_assert(std::is_void<event_t>{} ||
+				std::is_constructible<event_t, T...>{},
+				"tried to call fire with a type, not implicitly convertible to type of port."
+				"If conversion is required, do the cast before calling fire.");
+
+		const auto& handlers = base.storage.handlers();
+		if (handlers.empty())
+			return;
+
+		const auto last = handlers.end() - 1;
+		for (auto target = handlers.begin(); target != last; ++target)
+			(*target)->handler(static_cast<event_t>(event)...);
+		(*last)->handler(static_cast<event_t>(std::forward<T>(event))...);
+	}
+
+	/// Gives the number of connections from this port.
+	size_t nr_connected_handlers() const
+	{
+		return base.storage.handlers().size();
+	}
+
+	/**
+	 * \brief connects new connectable target to port.
+	 *
+	 * May be called concurrently to fire once reclaim_tick is requested,
+	 * the connection receives the events of all calls of fire starting after connect returned.
+	 * \param c the new target to be connected.
+	 */
+	template <class conn_t>
+	auto connect(conn_t&& c) &
+	{
+		static_assert(detail::has_result_of_type<conn_t, event_t>(),
+			"The type returned by this source is not compatible with the connection you "
+			"are trying to establish.");
+
+		base.add_handler(detail::handler_wrapper(std::forward<conn_t>(c)), get_sink(c));
+		reclaim_changes();
+		return port_connection<decltype(*this), conn_t, result_t>();
+	}
+
+	///Illegal overload for rvalue port to give better error message.
+	template<class con_t>
+	void connect(con_t&&) &&
+	{
+		static_assert(fc::always_false<con_t>(),
+				"Illegally tried to connect a temporary concurrent_event_source object.");
+	}
+
+	/**
+	 * \brief removes all connections to sink.
+	 *
+	 * May be called concurrently to fire once reclaim_tick is requested,
+	 * calls of fire starting after disconnect returned do not reach sink.
+	 * Destroy sink only after the next reclaim.
+	 */
+	template<class sink_t>
+	void disconnect(sink_t& sink)
+	{
+		base.storage.remove_handlers(std::hash<sink_t*>{}(&sink));
+		reclaim_changes();
+	}
+
+	/**
+	 * \brief frees connection lists replaced by connect and disconnect.
+	 * \pre fire is not running, call on the switch tick of the region firing the port.
+	 * \returns number of freed lists.
+	 */
+	size_t reclaim()
+	{
+		return base.storage.reclaim();
+	}
+
+	/**
+	 * \brief sink, which calls reclaim on every event, connect it to the reclaim tick.
+	 * From now on, connect and disconnect leave reclaiming to this sink.
+	 */
+	event_sink<void>& reclaim_tick()
+	{
+		reclaim_on_change.store(false);
+		return reclaimer;
+	}
+
+private:
+	using handler_t = typename detail::handle_type<result_t>::type;
+
+	void reclaim_changes()
+	{
+		if (reclaim_on_change.load())
+			reclaim();
+	}
+
+	detail::active_port_base<handler_t, detail::rcu_handler_policy> base;
+	event_sink<void> reclaimer{[this]{ reclaim(); }};
+	/// true as long as no reclaim tick is attached.
+	std::atomic<bool> reclaim_on_change{true};
+};
+
+} // namespace pure
+
+template<class T> struct is_active_source<pure::concurrent_event_source<T>> : std::true_type {};
+
+} // namespace fc
+
+#endif /* SRC_PORTS_CONCURRENT_EVENT_SOURCE_HPP_ */
@@ -9,24 +9,81 @@
 #define SRC_PORTS_PORT_TRAITS_HPP_
 
 #include <flexcore/core/traits.hpp>
+#include <flexcore/core/detail/inline_function.hpp>
+#include <flexcore/core/span.hpp>
+
+#include <cstddef>
 
 // A collection of port specific meta functions and traits.
 
+#ifndef FLEXCORE_PORT_HANDLER_CAPACITY
+/**
+ * \brief bytes of inline storage of every connection stored in a port.
+ * Larger connections are allocated on the heap. Can be set as compile definition.
+ */
+#define FLEXCORE_PORT_HANDLER_CAPACITY (6 * sizeof(void*))
+#endif
+
 namespace fc
 {
 namespace detail
 {
 
+/// size of the inline storage of connections in ports, \see FLEXCORE_PORT_HANDLER_CAPACITY
+constexpr size_t port_handler_capacity = FLEXCORE_PORT_HANDLER_CAPACITY;
+
+/// type erased connection stored in ports, stores chains of connections without allocation.
+template<class signature_t>
+using port_handler = inline_function<signature_t, port_handler_capacity>;
+
 template<class event_t>
 struct handle_type
 {
-	using type = std::function<void(event_t)>; // need rvalue ref here?
+	using type = port_handler<void(event_t)>; // need rvalue ref here?
 };
 
 template<>
 struct handle_type<void>
 {
-	using type = std::function<void()>;
+	using type = port_handler<void()>;
+};
+
+/// type of batches of events, a batch of void events is the number of events.
+template<class event_t>
+struct batch_type
+{
+	using type = span<const event_t>;
+};
+
+template<>
+struct batch_type<void>
+{
+	using type = size_t;
+};
+
+/// connection of an event_source, stores either a handler of single events or of batches.
+template<class event_t>
+struct event_handler
+{
+	explicit operator bool() const { return single || batch; }
+
+	typename handle_type<event_t>::type single;
+	port_handler<void(typename batch_type<event_t>::type)> batch;
+};
+
+/**
+ * \brief true if sink_t can receive batches of type batch_t.
+ * Whether it does is decided at runtime by sink_t::accepts_batches.
+ */
+template<class sink_t, class batch_t, class enable = void>
+struct may_accept_batches : std::false_type {};
+
+template<class sink_t, class batch_t>
+struct may_accept_batches<sink_t, batch_t, always_void<decltype(
+		std::declval<const sink_t&>().accepts_batches(),
+		std::declval<typename sink_t::batch_t*>())>>
+	: std::is_same<typename sink_t::batch_t, batch_t>
+{
 };
 
 template <template <class...> class mixin_t, class port_t>
@@ -7,10 +7,15 @@
 #ifndef SRC_PORTS_PORT_UTILS_HPP_
 #define SRC_PORTS_PORT_UTILS_HPP_
 
-#include <algorithm>
+#include <flexcore/pure/detail/slot_list.hpp>
+
+#include <atomic>
 #include <cassert>
 #include <functional>
-#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace fc
@@ -18,10 +23,9 @@ namespace fc
 namespace detail
 {
 
-// std::function requires that the stored object be copyable. Once we arrive at the active port's
-// connect member function, the argument is either an rvalue copyable object or an lvalue
-// potentially move only type. So for lvalues it is necessary to construct a copyable wrapper
-// (forwarding lambda or std::ref will do).
+// Once we arrive at the active port's connect member function, the argument is either an rvalue
+// connection, which is moved into the port, or an lvalue, like a sink,
+// which is referenced by the port instead of being copied (std::ref will do).
 template <class conn_t>
 auto handler_wrapper(conn_t& c)
 {
@@ -42,14 +46,13 @@ public:
 	single_handler_policy(single_handler_policy&& p)
 	    : handler_hash(p.handler_hash)
 	{
-		// libc++ doesn't correctly handle move ctr of std::function, it just copies.
-		// swap takes care of that.
+		// swap leaves p without handler, even if the handler type copies on move.
 		swap(handlers, p.handlers);
 	}
 
-	void add_handler(const handler_t& handler_, size_t hash)
+	void add_handler(handler_t handler_, size_t hash)
 	{
-		handlers = handler_;
+		handlers = std::move(handler_);
 		handler_hash = hash;
 	}
 	void remove_handler(size_t hash)
@@ -65,38 +68,136 @@ public:
 		// connection has already been broken when source2 was connected. That's why this is a check
 		// and not an assert.
 		if (hash == handler_hash)
-			handlers = {};
+			handlers = nullptr;
 	}
 
 	handler_t handlers;
 	size_t handler_hash;
 };
 
-/// Policy class for circuit breaker when multiple handlers can be connected at once.
+/**
+ * \brief Policy class for circuit breaker when multiple handlers can be connected at once.
+ *
+ * Handlers are called in the order they have been added,
+ * adding and removing handlers takes constant time, even with many connections.
+ */
 template <class handler_t>
 struct multiple_handler_policy
 {
 public:
-	/// \pre The handler corresponding to hash has been pushed_back to handlers.
-	void add_handler(const handler_t& handler, size_t hash)
+	void add_handler(handler_t handler, size_t hash)
+	{
+		handles.emplace(hash, handlers.push_back(std::move(handler)));
+	}
+	/// \pre a handler has been added with hash.
+	void remove_handler(size_t hash)
+	{
+		const auto handle = handles.find(hash);
+		assert(handle != handles.end());
+		handlers.erase(handle->second);
+		handles.erase(handle);
+	}
+
+	slot_list<handler_t> handlers;
+	/// handles of handlers by the hash of their sink, a sink can be connected multiple times.
+	std::unordered_multimap<size_t, typename slot_list<handler_t>::handle> handles;
+};
+
+/**
+ * \brief Policy class for circuit breaker, whose handlers can change while the port is used.
+ *
+ * Handlers are stored in immutable lists, which are read without locks.
+ * Adding and removing handlers copies the current list and publishes the copy atomically,
+ * thus readers see either the old or the new list, never a partial change.
+ * Replaced lists are kept until reclaim is called,
+ * as readers might still be iterating them.
+ *
+ * \pre reclaim is never called while handlers() is read,
+ * for instance only on the switch tick of the region reading the handlers.
+ */
+template <class handler_t>
+struct rcu_handler_policy
+{
+public:
+	struct entry
+	{
+		size_t hash;
+		handler_t handler;
+	};
+	using list_t = std::vector<std::shared_ptr<const entry>>;
+
+	rcu_handler_policy() : current(new list_t{}) {}
+	rcu_handler_policy(rcu_handler_policy&& p)
+		: current(nullptr)
 	{
-		handlers.push_back(handler);
-		handler_hashes.push_back(hash);
+		std::lock_guard<std::mutex> lock(p.writer);
+		current.store(p.current.exchange(new list_t{}));
+		retired = std::move(p.retired);
 	}
+	~rcu_handler_policy() { delete current.load(); }
+
+	void add_handler(handler_t handler, size_t hash)
+	{
+		std::lock_guard<std::mutex> lock(writer);
+		auto next = std::make_unique<list_t>(*current.load(std::memory_order_relaxed));
+		next->push_back(std::make_shared<const entry>(entry{hash, std::move(handler)}));
+		publish(std::move(next));
+	}
+	/// removes one handler added with hash, does nothing if there is none.
 	void remove_handler(size_t hash)
 	{
-		assert(!handler_hashes.empty());
-		assert(!handlers.empty());
+		remove_if(hash, false);
+	}
+	/// removes all handlers added with hash.
+	void remove_handlers(size_t hash)
+	{
+		remove_if(hash, true);
+	}
+
+	/// current list of handlers, valid until the next call of reclaim.
+	const list_t& handlers() const
+	{
+		return *current.load(std::memory_order_acquire);
+	}
 
-		auto handler_position = find(begin(handler_hashes), end(handler_hashes), hash);
-		assert(handler_position != end(handler_hashes));
-		auto idx = distance(begin(handler_hashes), handler_position);
-		handlers.erase(begin(handlers) + idx);
-		handler_hashes.erase(begin(handler_hashes) + idx);
+	/// frees the lists replaced since the last call, \returns their number.
+	size_t reclaim()
+	{
+		std::lock_guard<std::mutex> lock(writer);
+		const auto freed = retired.size();
+		retired.clear();
+		return freed;
+	}
+
+private:
+	void remove_if(size_t hash, bool all)
+	{
+		std::lock_guard<std::mutex> lock(writer);
+		const auto& old = *current.load(std::memory_order_relaxed);
+		auto next = std::make_unique<list_t>();
+		next->reserve(old.size());
+		bool removed = false;
+		for (const auto& e : old)
+		{
+			if (e->hash == hash && (all || !removed))
+				removed = true;
+			else
+				next->push_back(e);
+		}
+		if (removed)
+			publish(std::move(next));
+	}
+
+	/// \pre writer is locked
+	void publish(std::unique_ptr<list_t> next)
+	{
+		retired.emplace_back(current.exchange(next.release(), std::memory_order_acq_rel));
 	}
 
-	std::vector<handler_t> handlers;
-	std::vector<size_t> handler_hashes;
+	std::atomic<list_t*> current;
+	/// serializes changes of handlers, readers never lock it.
+	std::mutex writer;
+	std::vector<std::unique_ptr<list_t>> retired;
 };
 
 /** \brief Register callbacks with passive port.
@@ -0,0 +1,168 @@
+#ifndef SRC_PORTS_DETAIL_SLOT_LIST_HPP_
+#define SRC_PORTS_DETAIL_SLOT_LIST_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace fc
+{
+namespace detail
+{
+
+/**
+ * \brief list of values in contiguous slots with O(1) insertion and removal by handle.
+ *
+ * Values are iterated in the order they have been inserted.
+ * Slots of removed values are reused, handles carry the generation of their slot,
+ * thus handles of removed values stay invalid after the slot has been reused.
+ *
+ * \tparam T type of the values, needs to be default constructible and move assignable.
+ */
+template<class T>
+class slot_list
+{
+	using index_t = uint32_t;
+	static constexpr index_t npos = std::numeric_limits<index_t>::max();
+
+	struct slot
+	{
+		T value{};
+		index_t prev = npos;
+		index_t next = npos;
+		/// incremented on removal, thus handles to the removed value are detected.
+		index_t generation = 0;
+	};
+
+public:
+	/// identifies a value in the slot_list.
+	struct handle
+	{
+		index_t index;
+		index_t generation;
+	};
+
+	template<class value_t, class list_t>
+	class basic_iterator
+	{
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = value_t*;
+		using reference = value_t&;
+
+		basic_iterator(list_t* list, index_t index) : list(list), index(index) {}
+
+		reference operator*() const { return list->slots[index].value; }
+		pointer operator->() const { return &list->slots[index].value; }
+		basic_iterator& operator++()
+		{
+			index = list->slots[index].next;
+			return *this;
+		}
+		basic_iterator& operator--()
+		{
+			index = index == npos ? list->tail : list->slots[index].prev;
+			return *this;
+		}
+		basic_iterator operator++(int) { auto tmp = *this; ++*this; return tmp; }
+		basic_iterator operator--(int) { auto tmp = *this; --*this; return tmp; }
+		bool operator==(const basic_iterator& other) const { return index == other.index; }
+		bool operator!=(const basic_iterator& other) const { return index != other.index; }
+
+	private:
+		list_t* list;
+		index_t index;
+	};
+
+	using iterator = basic_iterator<T, slot_list>;
+	using const_iterator = basic_iterator<const T, const slot_list>;
+
+	/// appends value at the end of the list, \returns handle to remove the value.
+	handle push_back(T value)
+	{
+		index_t index;
+		if (free_head != npos)
+		{
+			index = free_head;
+			free_head = slots[index].next;
+		}
+		else
+		{
+			assert(slots.size() < npos);
+			index = static_cast<index_t>(slots.size());
+			slots.emplace_back();
+		}
+
+		auto& s = slots[index];
+		s.value = std::move(value);
+		s.prev = tail;
+		s.next = npos;
+		if (tail != npos)
+			slots[tail].next = index;
+		else
+			head = index;
+		tail = index;
+		++count;
+		return handle{index, s.generation};
+	}
+
+	/// removes the value identified by h, does nothing if it has already been removed.
+	void erase(handle h)
+	{
+		if (!contains(h))
+			return;
+
+		auto& s = slots[h.index];
+		if (s.prev != npos)
+			slots[s.prev].next = s.next;
+		else
+			head = s.next;
+		if (s.next != npos)
+			slots[s.next].prev = s.prev;
+		else
+			tail = s.prev;
+
+		s.value = T{};
+		++s.generation;
+		s.prev = npos;
+		s.next = free_head;
+		free_head = h.index;
+		--count;
+	}
+
+	/// returns true if the value identified by h has not been removed.
+	bool contains(handle h) const
+	{
+		return h.index < slots.size() && slots[h.index].generation == h.generation;
+	}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	iterator begin() { return iterator{this, head}; }
+	iterator end() { return iterator{this, npos}; }
+	const_iterator begin() const { return const_iterator{this, head}; }
+	const_iterator end() const { return const_iterator{this, npos}; }
+
+private:
+	std::vector<slot> slots;
+	index_t head = npos;
+	index_t tail = npos;
+	/// first slot of the list of reusable slots, linked by next.
+	index_t free_head = npos;
+	size_t count = 0;
+};
+
+template<class T>
+constexpr typename slot_list<T>::index_t slot_list<T>::npos;
+
+} // namespace detail
+} // namespace fc
+
+#endif /* SRC_PORTS_DETAIL_SLOT_LIST_HPP_ */
@@ -19,7 +19,9 @@ namespace pure
  * \brief Input port for events, executes given actions on incoming events.
  *
  * event_sink fulfills passive_sink.
- * \invariant event_handler is always valid and callable
+ * An event_sink either handles single events or batches of events,
+ * batches are sent by event_source::fire_batch, single events are passed as batch of one.
+ * \invariant either event_handler or batch_handler is valid and callable
  * \tparam event_t type of event expected, must be copy_constructable or move_constructable
  * \ingroup ports
  */
@@ -28,37 +30,62 @@ struct event_sink
 {
 	using result_t = void;
 	using token_t = event_t;
+	/// batch of events, span<const event_t>, or the number of events for void events.
+	using batch_t = typename detail::batch_type<event_t>::type;
 
 	/**
 	 * \brief Construct event_sink with action to execute in events
 	 * \param action Action to execute with incoming events
-	 * \pre action must be function with signature void(event_t).
+	 * \pre action must be function with signature void(event_t) or void(batch_t).
+	 * Actions callable with both handle single events.
 	 */
 	template<class action_t>
 	explicit event_sink(action_t&& action) :
-			event_handler(std::forward<action_t>(action))
+			event_sink(std::forward<action_t>(action), std::conditional_t<
+					std::is_constructible<handler_t, action_t>{},
+					std::false_type,
+					std::is_constructible<batch_handler_t, action_t>>{})
 	{
-		static_assert(std::is_constructible<handler_t, action_t>(),
-				"action given to event_sink needs to have signature void(event_t)."
-				" Where event_t is type of token expected by event_sink.");
-		assert(event_handler);
+		assert(event_handler || batch_handler);
 	}
 
 	///event sinks are callable with event_t, which makes them connectables
 	template <class T>
 	auto operator()(T&& in_event) -> std::enable_if_t<std::is_convertible<T&&, event_t>{}>
 	{
-		assert(event_handler);
-		event_handler(std::forward<T>(in_event));
+		assert(event_handler || batch_handler);
+		if (event_handler)
+		{
+			event_handler(std::forward<T>(in_event));
+			return;
+		}
+		const typename batch_t::value_type& converted = in_event;
+		batch_handler(batch_t(&converted, 1));
 	}
 
 	template <class T = event_t, typename = std::enable_if_t<std::is_void<T>{}>>
 	void operator()()
 	{
-		assert(event_handler);
-		event_handler();
+		assert(event_handler || batch_handler);
+		if (event_handler)
+			event_handler();
+		else
+			batch_handler(1);
 	}
 
+	/**
+	 * \brief receives a batch of events
+	 * \pre accepts_batches(), event_source calls single events otherwise.
+	 */
+	void operator()(batch_t events)
+	{
+		assert(batch_handler);
+		batch_handler(events);
+	}
+
+	/// returns true if the sink has been constructed with a handler of batches.
+	bool accepts_batches() const noexcept { return static_cast<bool>(batch_handler); }
+
 	event_sink(const event_sink&) = delete;
 	event_sink(event_sink&& o)
 	{
@@ -67,14 +94,16 @@ struct event_sink
 		// NDEBUG is defined) the moved-from-object can still disconnect
 		// itself.
 		swap(o.event_handler, event_handler);
-		assert(event_handler);
+		swap(o.batch_handler, batch_handler);
+		assert(event_handler || batch_handler);
 	}
 
 	event_sink& operator=(event_sink&& o)
 	{
 		assert(o.connection_breakers.empty());
 		swap(o.event_handler, event_handler);
-		assert(event_handler);
+		swap(o.batch_handler, batch_handler);
+		assert(event_handler || batch_handler);
 		return *this;
 	}
 
@@ -99,7 +128,24 @@ struct event_sink
 
 private:
 	using handler_t = typename detail::handle_type<event_t>::type;
+	using batch_handler_t = detail::port_handler<void(batch_t)>;
+
+	template<class action_t>
+	event_sink(action_t&& action, std::false_type) :
+			event_handler(std::forward<action_t>(action))
+	{
+		static_assert(std::is_constructible<handler_t, action_t>(),
+				"action given to event_sink needs to have signature void(event_t)."
+				" Where event_t is type of token expected by event_sink.");
+	}
+	template<class action_t>
+	event_sink(action_t&& action, std::true_type) :
+			batch_handler(std::forward<action_t>(action))
+	{
+	}
+
 	handler_t event_handler;
+	batch_handler_t batch_handler;
 	std::vector<std::weak_ptr<std::function<void(size_t)>>> connection_breakers;
 };
 
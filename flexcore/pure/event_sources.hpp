@@ -9,7 +9,9 @@
 #include <flexcore/pure/port_connection.hpp>
 
 #include <cassert>
+#include <iterator>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace fc
@@ -40,6 +42,10 @@ struct event_source
 
 	/**
 	 * \brief Sends parameter as event to all connected conntables and event_sinks.
+	 *
+	 * All connections but the last receive a copy of event,
+	 * the last one receives event itself, thus rvalue events are moved into it.
+	 * Use shared_payload to send large tokens to many connections without copies.
 	 * \param event token to be sent through this port.
 	 */
 	template<class... T>
@@ -53,13 +59,72 @@ struct event_source
 				"tried to call fire with a type, not implicitly convertible to type of port."
 				"If conversion is required, do the cast before calling fire.");
 
-		for (auto& target : base.storage.handlers)
+		auto& handlers = base.storage.handlers;
+		if (handlers.empty())
+			return;
+
+		const auto last = std::prev(handlers.end());
+		for (auto target = handlers.begin(); target != last; ++target)
+			send(*target, event...);
+		send(*last, std::forward<T>(event)...);
+	}
+
+	/**
+	 * \brief Sends a batch of events to all connections.
+	 *
+	 * Connections to sinks, which accept batches, receive the batch in a single call.
+	 * All other connections receive the events one by one,
+	 * the last of them receives the events themselves, if they are not const.
+	 * Connections accepting batches are called first, the others then receive
+	 * the events interleaved, as if fire was called for each event.
+	 * \param events contiguous events to be sent through this port.
+	 */
+	template<class element_t>
+	void fire_batch(span<element_t> events)
+	{
+		static_assert(std::is_same<std::remove_const_t<element_t>,
+				std::remove_const_t<result_t>>{},
+				"batch needs to contain events of the type of the port.");
+
+		auto& handlers = base.storage.handlers;
+		const auto last_single = send_batches(span<const result_t>(events));
+		if (last_single == handlers.end())
+			return;
+
+		using forward_t = std::conditional_t<std::is_const<element_t>{},
+				const element_t&, element_t&&>;
+		for (auto& e : events)
 		{
-			assert(target);
-			target(static_cast<event_t>(event)...);
+			for (auto target = handlers.begin(); target != last_single; ++target)
+				if (target->single)
+					target->single(static_cast<const result_t&>(e));
+			last_single->single(static_cast<forward_t>(e));
 		}
 	}
 
+	/// Sends the events of a contiguous container, like std::vector, as batch.
+	template<class container_t, class T = result_t, class = std::enable_if_t<
+			!std::is_void<T>{} && !is_instantiation_of<span, container_t>{}>>
+	void fire_batch(const container_t& events)
+	{
+		fire_batch(span<const result_t>(events));
+	}
+
+	/// Sends count void events, connections without batch handler receive them as fire would.
+	template<class T = result_t, class = std::enable_if_t<std::is_void<T>{}>>
+	void fire_batch(size_t count)
+	{
+		auto& handlers = base.storage.handlers;
+		const auto last_single = send_batches(count);
+		if (last_single == handlers.end())
+			return;
+
+		for (size_t i = 0; i != count; ++i)
+			for (auto target = handlers.begin(); target != std::next(last_single); ++target)
+				if (target->single)
+					target->single();
+	}
+
 	/// Gives the number of connections from this port.
 	size_t nr_connected_handlers() const
 	{
@@ -82,7 +147,8 @@ struct event_source
 			"The type returned by this source is not compatible with the connection you "
 			"are trying to establish.");
 
-		base.add_handler(detail::handler_wrapper(std::forward<conn_t>(c)), get_sink(c));
+		base.add_handler(make_handler(std::forward<conn_t>(c),
+				detail::may_accept_batches<std::decay_t<conn_t>, batch_t>{}), get_sink(c));
 
 		assert(!base.storage.handlers.empty());
 		return port_connection<decltype(*this), conn_t, result_t>();
@@ -97,7 +163,68 @@ struct event_source
 	}
 
 private:
-	using handler_t = typename detail::handle_type<result_t>::type;
+	using handler_t = detail::event_handler<result_t>;
+	using batch_t = typename detail::batch_type<result_t>::type;
+
+	template<class conn_t>
+	static handler_t make_handler(conn_t&& c, std::false_type)
+	{
+		handler_t handler;
+		handler.single = detail::handler_wrapper(std::forward<conn_t>(c));
+		return handler;
+	}
+	/// stores sinks, which accept batches, as handler of batches.
+	template<class conn_t>
+	static handler_t make_handler(conn_t&& c, std::true_type)
+	{
+		if (!c.accepts_batches())
+			return make_handler(std::forward<conn_t>(c), std::false_type{});
+		handler_t handler;
+		handler.batch = detail::handler_wrapper(std::forward<conn_t>(c));
+		return handler;
+	}
+
+	/// sends a single event, handlers of batches receive a batch of one.
+	template<class... T>
+	static void send(handler_t& target, T&&... event)
+	{
+		assert(target);
+		if (target.single)
+			target.single(static_cast<event_t>(std::forward<T>(event))...);
+		else
+			send_batch_of_one(target, event...);
+	}
+	static void send_batch_of_one(handler_t& target)
+	{
+		target.batch(1);
+	}
+	template<class T>
+	static void send_batch_of_one(handler_t& target, const T& event)
+	{
+		const result_t& converted = event;
+		target.batch(batch_t(&converted, 1));
+	}
+
+	/**
+	 * \brief sends batch to all handlers of batches.
+	 * \returns the last handler of single events, end of the handlers if there is none.
+	 */
+	template<class batch_arg_t>
+	auto send_batches(batch_arg_t batch)
+	{
+		auto& handlers = base.storage.handlers;
+		auto last_single = handlers.end();
+		for (auto target = handlers.begin(); target != handlers.end(); ++target)
+		{
+			assert(*target);
+			if (target->batch)
+				target->batch(batch);
+			else
+				last_single = target;
+		}
+		return last_single;
+	}
+
 	// Stores event_handlers in a vector, the node needs to send
 	// to all connected event_handlers when an event is fired.
 	detail::active_port_base<handler_t, detail::multiple_handler_policy> base;
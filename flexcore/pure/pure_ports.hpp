@@ -1,10 +1,14 @@
 #ifndef SRC_PORTS_PURE_PORTS_HPP_
 #define SRC_PORTS_PURE_PORTS_HPP_
 
+#include <flexcore/pure/concurrent_event_source.hpp>
 #include <flexcore/pure/event_sources.hpp>
 #include <flexcore/pure/event_sinks.hpp>
 #include <flexcore/pure/state_sink.hpp>
 #include <flexcore/pure/state_sources.hpp>
+#include <flexcore/pure/shared_payload.hpp>
+#include <flexcore/pure/static_ports.hpp>
+#include <flexcore/pure/versioned_state.hpp>
 
 /**
 * \defgroup ports ports
@@ -0,0 +1,65 @@
+#ifndef SRC_PORTS_SHARED_PAYLOAD_HPP_
+#define SRC_PORTS_SHARED_PAYLOAD_HPP_
+
+#include <cassert>
+#include <memory>
+#include <utility>
+
+namespace fc
+{
+namespace pure
+{
+
+/**
+ * \brief immutable token, which is shared instead of copied.
+ *
+ * Ports copy tokens for all but the last connection.
+ * For large tokens, like images or point clouds, sent to several connections,
+ * wrap the token in shared_payload, then copies only increment a reference count.
+ * Since the payload is const, connections cannot observe modifications of other connections.
+ *
+ * \tparam T type of the payload
+ * \ingroup ports
+ */
+template<class T>
+class shared_payload
+{
+public:
+	using value_type = T;
+
+	/// constructs an empty shared_payload, which needs to be assigned before it is read.
+	shared_payload() = default;
+	/// takes ownership of value.
+	explicit shared_payload(T value)
+		: payload(std::make_shared<const T>(std::move(value)))
+	{
+	}
+
+	const T& get() const
+	{
+		assert(payload);
+		return *payload;
+	}
+	const T& operator*() const { return get(); }
+	const T* operator->() const { return &get(); }
+
+	explicit operator bool() const { return static_cast<bool>(payload); }
+
+	/// number of tokens sharing the payload, zero if empty.
+	long use_count() const { return payload.use_count(); }
+
+private:
+	std::shared_ptr<const T> payload;
+};
+
+/// constructs a shared_payload, whose payload is constructed from args.
+template<class T, class... args_t>
+shared_payload<T> make_shared_payload(args_t&&... args)
+{
+	return shared_payload<T>{T(std::forward<args_t>(args)...)};
+}
+
+} // namespace pure
+} // namespace fc
+
+#endif /* SRC_PORTS_SHARED_PAYLOAD_HPP_ */
@@ -39,7 +39,7 @@ public:
 	 */
 	data_t get() const
 	{
-		if (!base.storage.handlers) //handlers is std::function with operator bool
+		if (!base.storage.handlers) //handlers is port_handler with operator bool
 			throw not_connected(
 					"tried to pull data through a state_sink"
 					" which is not connected");
@@ -79,7 +79,7 @@ public:
 	using result_t = void ;
 	using token_t = data_t;
 private:
-	detail::active_port_base<std::function<data_t()>, detail::single_handler_policy> base;
+	detail::active_port_base<detail::port_handler<data_t()>, detail::single_handler_policy> base;
 };
 
 } // namespace pure
@@ -4,7 +4,9 @@
 #include <flexcore/core/connection.hpp>
 #include <flexcore/core/traits.hpp>
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <utility>
@@ -92,6 +94,89 @@ private:
 	std::vector<std::weak_ptr<std::function<void(size_t)>>> connection_breakers;
 };
 
+/**
+ * \brief State source port, which calls its function at most once per tick.
+ *
+ * The first pull after generation changed calls the function,
+ * all further pulls return a copy of the cached result.
+ * Use this for expensive states pulled by several sinks,
+ * with the generation of the tick_controller of the region the source belongs to,
+ * which changes on every switch tick of the region.
+ * The node aware fc::memoizing_state_source binds the generation of its region itself.
+ *
+ * \tparam data_t type of token provided by this port, needs to be copy constructible.
+ * \ingroup ports
+ */
+template<class data_t>
+class memoizing_state_source : public state_source<data_t>
+{
+public:
+	/**
+	 * \param generation counter which changes whenever the cached state is outdated,
+	 * e.g. tick_controller::generation. Needs to outlive the port.
+	 * \param f function which is called, when data is pulled and the cache is outdated.
+	 */
+	template<class provide_action>
+	memoizing_state_source(const std::atomic<uint64_t>& generation, provide_action&& f)
+		: memoizing_state_source(std::make_shared<cache>(
+				generation, std::forward<provide_action>(f)))
+	{
+	}
+
+	/// number of pulls answered from the cache.
+	size_t hits() const { return state->hits; }
+	/// number of pulls which called the function.
+	size_t misses() const { return state->misses; }
+
+private:
+	struct cache
+	{
+		template<class provide_action>
+		cache(const std::atomic<uint64_t>& generation, provide_action&& f)
+			: call(std::forward<provide_action>(f))
+			, generation(generation)
+		{
+			static_assert(std::is_constructible<std::function<data_t()>, provide_action>(),
+					"action given to memoizing_state_source needs to have signature data_t()."
+					" Where data_t is type of token provided by memoizing_state_source.");
+			assert(call);
+		}
+
+		data_t get()
+		{
+			const auto current = generation.load();
+			if (value && cached_generation == current)
+			{
+				++hits;
+				return *value;
+			}
+			++misses;
+			if (value)
+				*value = call();
+			else
+				value = std::make_unique<data_t>(call());
+			cached_generation = current;
+			return *value;
+		}
+
+		std::function<data_t()> call;
+		const std::atomic<uint64_t>& generation;
+		uint64_t cached_generation = 0;
+		std::unique_ptr<data_t> value;
+		size_t hits = 0;
+		size_t misses = 0;
+	};
+
+	// the cache is shared with the function of the base, thus the port stays movable.
+	explicit memoizing_state_source(std::shared_ptr<cache> c)
+		: state_source<data_t>([c]() { return c->get(); })
+		, state(std::move(c))
+	{
+	}
+
+	std::shared_ptr<cache> state;
+};
+
 } // namespace pure
 } // namespace fc
 
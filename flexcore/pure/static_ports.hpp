@@ -0,0 +1,218 @@
+#ifndef SRC_PORTS_STATIC_PORTS_HPP_
+#define SRC_PORTS_STATIC_PORTS_HPP_
+
+#include <flexcore/core/traits.hpp>
+#include <flexcore/core/connection_util.hpp>
+#include <flexcore/pure/detail/port_utils.hpp>
+
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace fc
+{
+namespace detail
+{
+/// tag to construct a static_event_source from the tuple of its connections.
+struct from_tuple {};
+}
+
+namespace pure
+{
+
+/**
+ * \brief Output port for events, whose connections are part of its type.
+ *
+ * In contrast to event_source, connections are not type erased.
+ * Thus fire calls all connections directly and the compiler can inline complete chains.
+ * Use this for chains, whose endpoints are all known at compile time,
+ * create it with make_static_event_source or extend it with connect.
+ *
+ * Connected lvalues, like event_sinks, are stored by reference and need to outlive the port.
+ * Connections cannot be removed, neither by disconnect nor by destruction of sinks.
+ *
+ * \tparam event_t type of event sent by the port.
+ * \tparam handler_t types of the connections, in the order they are called.
+ * \ingroup ports
+ */
+template<class event_t, class... handler_t>
+class static_event_source
+{
+public:
+	using result_t = std::remove_reference_t<event_t>;
+	using token_t = event_t;
+
+	static_event_source() = default;
+	explicit static_event_source(handler_t... handlers)
+		: handlers(std::move(handlers)...)
+	{
+	}
+
+	/**
+	 * \brief Sends parameter as event to all connections.
+	 *
+	 * As event_source, the last connection receives event itself, the others a copy.
+	 * \param event token to be sent through this port.
+	 */
+	template<class... T>
+	void fire(T&&... event)
+	{
+		static_assert(sizeof...(T) == 0 || sizeof...(T) == 1,
+				"we only allow single events, or void events atm");
+
+		static_assert(std::is_void<event_t>{} ||
+				std::is_constructible<event_t, T...>{},
+				"tried to call fire with a type, not implicitly convertible to type of port."
+				"If conversion is required, do the cast before calling fire.");
+
+		constexpr size_t nr_of_handlers = sizeof...(handler_t);
+		fire_impl(std::make_index_sequence<nr_of_handlers == 0 ? 0 : nr_of_handlers - 1>{},
+				event...);
+		fire_last(std::integral_constant<bool, nr_of_handlers != 0>{},
+				std::forward<T>(event)...);
+	}
+
+	/// Gives the number of connections from this port.
+	static constexpr size_t nr_connected_handlers()
+	{
+		return sizeof...(handler_t);
+	}
+
+	/**
+	 * \brief returns a port with all connections of this one and c.
+	 *
+	 * Since c is part of the type of the result, this port is consumed.
+	 * \param c the new connection, lvalues are referenced.
+	 */
+	template<class conn_t>
+	auto connect(conn_t&& c) &&
+	{
+		static_assert(detail::has_result_of_type<conn_t, event_t>(),
+			"The type returned by this source is not compatible with the connection you "
+			"are trying to establish.");
+
+		using new_handler_t =
+				std::decay_t<decltype(detail::handler_wrapper(std::forward<conn_t>(c)))>;
+		return static_event_source<event_t, handler_t..., new_handler_t>{
+				detail::from_tuple{}, std::tuple_cat(std::move(handlers),
+						std::make_tuple(new_handler_t(
+								detail::handler_wrapper(std::forward<conn_t>(c)))))};
+	}
+
+	///Illegal overload for lvalue port, since connecting changes the type of the port.
+	template<class conn_t>
+	void connect(conn_t&&) &
+	{
+		static_assert(::fc::always_false<conn_t>(),
+				"static_event_source can only be extended as rvalue, use std::move.");
+	}
+
+private:
+	template<class other_event_t, class... other_handler_t>
+	friend class static_event_source;
+
+	static_event_source(detail::from_tuple, std::tuple<handler_t...>&& handlers)
+		: handlers(std::move(handlers))
+	{
+	}
+
+	template<size_t... index, class... T>
+	void fire_impl(std::index_sequence<index...>, T&... event)
+	{
+		// calls all but the last connection in order,
+		// without the array the expansion is not sequenced.
+		static_cast<void>(std::initializer_list<int>{
+				(std::get<index>(handlers)(static_cast<event_t>(event)...), 0)...});
+	}
+
+	template<class... T>
+	void fire_last(std::true_type, T&&... event)
+	{
+		std::get<sizeof...(handler_t) - 1>(handlers)(
+				static_cast<event_t>(std::forward<T>(event))...);
+	}
+	template<class... T>
+	void fire_last(std::false_type, T&&...)
+	{
+	}
+
+	std::tuple<handler_t...> handlers;
+};
+
+/**
+ * \brief creates a static_event_source from connections
+ *
+ * \code{cpp}
+ * event_sink<int> sink{...};
+ * auto source = make_static_event_source<int>([](int i){ return i * 2; } >> sink);
+ * source.fire(1);
+ * \endcode
+ * \tparam event_t type of events sent by the port.
+ * \param connections connections of the port, lvalues are referenced.
+ */
+template<class event_t, class... conn_t>
+auto make_static_event_source(conn_t&&... connections)
+{
+	return static_event_source<event_t,
+			std::decay_t<decltype(detail::handler_wrapper(std::forward<conn_t>(connections)))>...>
+			{detail::handler_wrapper(std::forward<conn_t>(connections))...};
+}
+
+/**
+ * \brief Input port for states, whose connection is part of its type.
+ *
+ * In contrast to state_sink, the connection is not type erased,
+ * thus get calls the connection directly and the compiler can inline complete chains.
+ * Create it with make_static_state_sink.
+ * Connected lvalues, like state_sources, are stored by reference and need to outlive the port.
+ *
+ * \tparam data_t data type flowing through this port.
+ * \tparam connection_t type of the connection pulled by get.
+ * \ingroup ports
+ */
+template<class data_t, class connection_t>
+class static_state_sink
+{
+public:
+	using token_t = data_t;
+
+	explicit static_state_sink(connection_t connection)
+		: connection(std::move(connection))
+	{
+		static_assert(std::is_convertible<std::result_of_t<connection_t&()>, data_t>{},
+				"Type returned by connection needs to be convertible to type of port.");
+	}
+
+	/// pulls state from the connection.
+	data_t get() const
+	{
+		return connection();
+	}
+
+private:
+	mutable connection_t connection;
+};
+
+/**
+ * \brief creates a static_state_sink from a connection
+ *
+ * \code{cpp}
+ * state_source<int> source{...};
+ * auto sink = make_static_state_sink<int>(source >> [](int i){ return i * 2; });
+ * \endcode
+ * \tparam data_t type of the state of the port.
+ * \param connection connection pulled by the port, lvalues are referenced.
+ */
+template<class data_t, class conn_t>
+auto make_static_state_sink(conn_t&& connection)
+{
+	return static_state_sink<data_t,
+			std::decay_t<decltype(detail::handler_wrapper(std::forward<conn_t>(connection)))>>
+			{detail::handler_wrapper(std::forward<conn_t>(connection))};
+}
+
+} // namespace pure
+} // namespace fc
+
+#endif /* SRC_PORTS_STATIC_PORTS_HPP_ */
@@ -0,0 +1,152 @@
+#ifndef SRC_PORTS_VERSIONED_STATE_HPP_
+#define SRC_PORTS_VERSIONED_STATE_HPP_
+
+#include <flexcore/pure/shared_payload.hpp>
+#include <flexcore/pure/state_sources.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace fc
+{
+namespace pure
+{
+
+/**
+ * \brief state token, which carries the version of the state.
+ *
+ * The version changes whenever the state changes,
+ * thus connections can cache their results for a version, see incremental.
+ * The state is shared between copies of the token, thus pulling it does not copy it.
+ * \tparam T type of the state
+ * \ingroup ports
+ */
+template<class T>
+struct versioned
+{
+	const T& get() const { return *value; }
+	const T& operator*() const { return get(); }
+	const T* operator->() const { return &get(); }
+
+	shared_payload<T> value;
+	uint64_t version = 0;
+};
+
+/**
+ * \brief State source port, which stores a state and publishes its version.
+ *
+ * Provides versioned<data_t>, whose version changes on every call of set.
+ * Connect it through incremental connections, to only recompute states
+ * whose inputs changed since the last pull.
+ * \tparam data_t type of the stored state.
+ * \ingroup ports
+ */
+template<class data_t>
+class versioned_state_source : public state_source<versioned<data_t>>
+{
+public:
+	explicit versioned_state_source(data_t initial_value)
+		: versioned_state_source(std::make_shared<versioned<data_t>>(
+				versioned<data_t>{shared_payload<data_t>{std::move(initial_value)}, 1}))
+	{
+	}
+
+	/// replaces the state and increments the version.
+	void set(data_t value)
+	{
+		state->value = shared_payload<data_t>{std::move(value)};
+		++state->version;
+	}
+
+	const data_t& get() const { return state->get(); }
+	uint64_t version() const { return state->version; }
+
+private:
+	// the state is shared with the function of the base, thus the port stays movable.
+	explicit versioned_state_source(std::shared_ptr<versioned<data_t>> s)
+		: state_source<versioned<data_t>>([s]() { return *s; })
+		, state(std::move(s))
+	{
+	}
+
+	std::shared_ptr<versioned<data_t>> state;
+};
+
+} // namespace pure
+
+namespace detail
+{
+template<class T>
+auto equal_states(const T& lhs, const T& rhs, int) -> decltype(bool(lhs == rhs))
+{
+	return lhs == rhs;
+}
+/// states without operator== are always treated as changed.
+template<class T>
+bool equal_states(const T&, const T&, long)
+{
+	return false;
+}
+
+/// connectable which caches the result of operation for the last version of its input.
+template<class in_t, class operation_t>
+struct incremental_operation
+{
+	using result_t = pure::versioned<std::decay_t<std::result_of_t<operation_t&(const in_t&)>>>;
+
+	explicit incremental_operation(operation_t op)
+		: op(std::move(op))
+	{
+	}
+
+	result_t operator()(const pure::versioned<in_t>& in)
+	{
+		if (output.value && in.version == input_version)
+			return output;
+
+		auto result = op(in.get());
+		input_version = in.version;
+		// equal results keep their version, thus later connections keep their caches.
+		if (output.value && equal_states(result, output.get(), 0))
+			return output;
+		output.value = decltype(output.value){std::move(result)};
+		++output.version;
+		return output;
+	}
+
+	operation_t op;
+	uint64_t input_version = 0;
+	result_t output{};
+};
+} // namespace detail
+
+namespace pure
+{
+
+/**
+ * \brief creates a connection of versioned states, which calls op only if its input changed.
+ *
+ * Takes versioned<in_t> and provides versioned states of the results of op.
+ * If the version of the input did not change since the last pull, the cached result is returned.
+ * If op returns a result equal to the last one, the version of the output does not change either,
+ * thus chains of incremental connections only recompute states whose inputs changed.
+ *
+ * \code{cpp}
+ * versioned_state_source<config> source{load_config()};
+ * source >> incremental<config>(build_lookup_table) >> sink;
+ * \endcode
+ * \tparam in_t type of the input state
+ * \param op operation called with const in_t&
+ */
+template<class in_t, class operation_t>
+auto incremental(operation_t op)
+{
+	return fc::detail::incremental_operation<in_t, operation_t>(std::move(op));
+}
+
+} // namespace pure
+} // namespace fc
+
+#endif /* SRC_PORTS_VERSIONED_STATE_HPP_ */
@@ -0,0 +1,172 @@
+#include <flexcore/scheduler/affinity.hpp>
+
+#include <array>
+#include <cassert>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace fc
+{
+namespace thread
+{
+
+constexpr size_t cpu_set::max_cpus;
+
+cpu_set::cpu_set(std::initializer_list<size_t> cpu_list)
+{
+	for (auto cpu : cpu_list)
+		add(cpu);
+}
+
+cpu_set cpu_set::from_list(const std::string& list)
+{
+	auto to_cpu = [&list](const std::string& number)
+	{
+		if (number.empty() || number.find_first_not_of("0123456789") != std::string::npos)
+			throw std::invalid_argument{"malformed cpu list: " + list};
+		const auto cpu = std::stoul(number);
+		if (cpu >= max_cpus)
+			throw std::invalid_argument{"cpu out of range in cpu list: " + list};
+		return static_cast<size_t>(cpu);
+	};
+
+	cpu_set result;
+	std::istringstream stream{list};
+	std::string range;
+	while (std::getline(stream, range, ','))
+	{
+		// lists read from sysfs end with a newline.
+		const auto end = range.find_last_not_of(" \n");
+		range.erase(end == std::string::npos ? 0 : end + 1);
+		if (range.empty())
+			continue;
+
+		const auto dash = range.find('-');
+		if (dash == std::string::npos)
+		{
+			result.add(to_cpu(range));
+			continue;
+		}
+		const auto first = to_cpu(range.substr(0, dash));
+		const auto last = to_cpu(range.substr(dash + 1));
+		if (first > last)
+			throw std::invalid_argument{"malformed cpu list: " + list};
+		for (auto cpu = first; cpu <= last; ++cpu)
+			result.add(cpu);
+	}
+	return result;
+}
+
+cpu_set cpu_set::numa_node(size_t node)
+{
+	const auto path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+	std::ifstream file{path};
+	std::string list;
+	if (!file || !std::getline(file, list))
+		throw std::runtime_error{"unknown numa node, cannot read " + path};
+	return from_list(list);
+}
+
+std::vector<cpu_set> cpu_set::single_cpus()
+{
+	std::vector<cpu_set> result;
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+		return result;
+	for (size_t cpu = 0; cpu != max_cpus; ++cpu)
+		if (CPU_ISSET(cpu, &allowed))
+			result.push_back(cpu_set{cpu});
+	return result;
+}
+
+std::vector<size_t> cpu_set::to_vector() const
+{
+	std::vector<size_t> result;
+	for (size_t cpu = 0; cpu != max_cpus; ++cpu)
+		if (cpus.test(cpu))
+			result.push_back(cpu);
+	return result;
+}
+
+bool pin_current_thread(const cpu_set& cpus)
+{
+	assert(!cpus.empty());
+	cpu_set_t native;
+	CPU_ZERO(&native);
+	for (auto cpu : cpus.to_vector())
+		CPU_SET(cpu, &native);
+	return pthread_setaffinity_np(pthread_self(), sizeof(native), &native) == 0;
+}
+
+int numa_node_of(const cpu_set& cpus)
+{
+	if (cpus.empty())
+		return -1;
+	std::ifstream file{"/sys/devices/system/node/online"};
+	std::string list;
+	if (!file || !std::getline(file, list))
+		return -1;
+	for (const auto node : cpu_set::from_list(list).to_vector())
+		if (cpus.is_subset_of(cpu_set::numa_node(node)))
+			return static_cast<int>(node);
+	return -1;
+}
+
+int numa_node_of_address(const void* address)
+{
+	int node = -1;
+	// get_mempolicy is called directly, thus flexcore does not depend on libnuma.
+	if (syscall(SYS_get_mempolicy, &node, nullptr, 0,
+			const_cast<void*>(address), MPOL_F_NODE | MPOL_F_ADDR) != 0)
+		return -1;
+	return node;
+}
+
+void run_pinned(const cpu_set& cpus, const std::function<void()>& work)
+{
+	if (cpus.empty())
+	{
+		work();
+		return;
+	}
+
+	const int node = numa_node_of(cpus);
+	std::exception_ptr error;
+	std::thread builder{[&]
+	{
+		// failing to pin the thread or to set its policy is not fatal,
+		// the memory is then placed as if work ran on the calling thread.
+		pin_current_thread(cpus);
+		if (node >= 0)
+		{
+			std::array<unsigned long, cpu_set::max_cpus / (8 * sizeof(unsigned long))> nodes{};
+			const auto bits = 8 * sizeof(unsigned long);
+			nodes[node / bits] |= 1ul << (node % bits);
+			syscall(SYS_set_mempolicy, MPOL_PREFERRED, nodes.data(), nodes.size() * bits + 1);
+		}
+		try
+		{
+			work();
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+	}};
+	builder.join();
+	if (error)
+		std::rethrow_exception(error);
+}
+
+} // namespace thread
+} // namespace fc
@@ -0,0 +1,96 @@
+#ifndef SRC_SCHEDULER_AFFINITY_HPP_
+#define SRC_SCHEDULER_AFFINITY_HPP_
+
+#include <bitset>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace fc
+{
+namespace thread
+{
+
+/**
+ * \brief set of logical cpus, threads and regions can be pinned to.
+ *
+ * An empty set means that no restriction applies.
+ */
+class cpu_set
+{
+public:
+	/// highest number of cpus supported, matches CPU_SETSIZE of glibc.
+	static constexpr size_t max_cpus = 1024;
+
+	cpu_set() = default;
+	/// \pre all cpus < max_cpus, throws std::out_of_range otherwise.
+	cpu_set(std::initializer_list<size_t> cpus);
+
+	/**
+	 * \brief parses a list of cpus in the format used by linux, e.g. "0-3,8,10-11".
+	 * Throws std::invalid_argument if list is malformed or contains cpus >= max_cpus.
+	 */
+	static cpu_set from_list(const std::string& list);
+
+	/**
+	 * \brief returns all cpus of a numa node.
+	 * Throws std::runtime_error if the node does not exist.
+	 */
+	static cpu_set numa_node(size_t node);
+
+	/// returns one set for each cpu the current process is allowed to run on.
+	static std::vector<cpu_set> single_cpus();
+
+	/// \pre cpu < max_cpus, throws std::out_of_range otherwise.
+	void add(size_t cpu) { cpus.set(cpu); }
+	bool contains(size_t cpu) const { return cpu < max_cpus && cpus.test(cpu); }
+	bool empty() const { return cpus.none(); }
+	size_t size() const { return cpus.count(); }
+	/// returns true if all cpus in *this are also in other.
+	bool is_subset_of(const cpu_set& other) const { return (cpus & ~other.cpus).none(); }
+	/// returns the cpus contained in ascending order.
+	std::vector<size_t> to_vector() const;
+
+	bool operator==(const cpu_set& other) const { return cpus == other.cpus; }
+	bool operator!=(const cpu_set& other) const { return cpus != other.cpus; }
+
+private:
+	std::bitset<max_cpus> cpus;
+};
+
+/**
+ * \brief restricts the calling thread to the given cpus.
+ * \return true if the affinity was set, false if the operating system refused.
+ * \pre !cpus.empty()
+ */
+bool pin_current_thread(const cpu_set& cpus);
+
+/**
+ * \brief returns the numa node all cpus belong to.
+ * Returns -1 if cpus is empty, spans several nodes or the topology cannot be read.
+ */
+int numa_node_of(const cpu_set& cpus);
+
+/**
+ * \brief returns the numa node the page containing address is placed on, -1 if unknown.
+ * Pages which have not been touched yet are placed by this call.
+ */
+int numa_node_of_address(const void* address);
+
+/**
+ * \brief runs work on a thread pinned to cpus and waits for it to finish.
+ *
+ * Linux places memory on the numa node of the thread which touches it first.
+ * The thread additionally prefers the node of cpus for all of its allocations.
+ * Thus objects constructed by work, like the nodes and buffers of a region,
+ * are placed on the node of the cpus running the region.
+ * Exceptions thrown by work are rethrown. Runs work on the calling thread if cpus is empty.
+ */
+void run_pinned(const cpu_set& cpus, const std::function<void()>& work);
+
+} // namespace thread
+} // namespace fc
+
+#endif /* SRC_SCHEDULER_AFFINITY_HPP_ */
@@ -12,18 +12,42 @@ namespace fc
 
 namespace chr = std::chrono;
 
-std::atomic<virtual_clock::system::time_point>
-		virtual_clock::system::current_time{(
-				virtual_clock::system::time_point(
-						virtual_clock::system::duration::zero()))};
-std::atomic<virtual_clock::steady::time_point>
-		virtual_clock::steady::current_time{(
-				virtual_clock::steady::time_point(
-						virtual_clock::steady::duration::zero()))};
+namespace
+{
+/// instance selected by the innermost scope of the thread, nullptr for the global instance.
+thread_local const virtual_clock::instance* thread_clock = nullptr;
+} // namespace
+
+virtual_clock::instance& virtual_clock::global_instance() noexcept
+{
+	static instance clock;
+	return clock;
+}
+
+const virtual_clock::instance& virtual_clock::global() noexcept
+{
+	return global_instance();
+}
+
+const virtual_clock::instance& virtual_clock::current() noexcept
+{
+	return thread_clock ? *thread_clock : global_instance();
+}
+
+virtual_clock::scope::scope(const instance* clock) noexcept
+	: previous(thread_clock)
+{
+	thread_clock = clock;
+}
+
+virtual_clock::scope::~scope()
+{
+	thread_clock = previous;
+}
 
 virtual_clock::system::time_point virtual_clock::system::now() noexcept
 {
-	return current_time.load();
+	return current().system_now();
 }
 
 std::time_t virtual_clock::system::to_time_t(const time_point& t)
@@ -41,26 +65,9 @@ virtual_clock::system::time_point virtual_clock::system::from_time_t(std::time_t
 	return chr::time_point_cast<virtual_clock::duration>(tmp);
 }
 
-void virtual_clock::system::advance(duration d) noexcept
-{
-	const auto tmp = current_time.load();
-	current_time.store(tmp + d);
-}
-
-void virtual_clock::system::set_time(time_point r) noexcept
-{
-	current_time.store(r);
-}
-
 virtual_clock::steady::time_point virtual_clock::steady::now() noexcept
 {
-	return current_time.load();
-}
-
-void virtual_clock::steady::advance(duration d) noexcept
-{
-	const auto tmp = current_time.load();
-	current_time.store(tmp + d);
+	return current().steady_now();
 }
 
 }  //namespace fc
@@ -36,6 +36,11 @@ struct wall_clock
  * The virtual clock is independent of the system real time clock.
  * It is used to determine timings in simulations and replays of logged data.
  * The clock itself is controlled by the scheduler of the application.
+ *
+ * Every scheduler owns its own virtual_clock::instance.
+ * steady::now() and system::now() return the time of the instance
+ * which is active in the calling thread, see virtual_clock::scope,
+ * and the time of a process wide instance controlled by master_clock otherwise.
  */
 struct virtual_clock
 {
@@ -67,20 +72,12 @@ struct virtual_clock
 		using time_point = std::chrono::time_point<virtual_clock::system, duration>;
 		/**
 		 * \brief returns current absolute simulation time
-		 * \return A time point representing the current virtual time.
+		 * \return A time point representing the current virtual time
+		 * of the instance active in the calling thread.
 		 */
 		static time_point now() noexcept;
 		static std::time_t to_time_t( const time_point& t );
 		static time_point from_time_t( std::time_t t );
-
-		template<class T>
-		friend class master_clock;
-	private:
-
-		static void advance(duration d) noexcept;
-		static void set_time(time_point r) noexcept;
-
-		static std::atomic<time_point> current_time;
 	};
 
 	/**
@@ -99,19 +96,71 @@ struct virtual_clock
 
 		/**
 		 * \brief returns current relative simulation time
-		 * \return A time point representing the current virtual time.
-		 * \post if now is called twice with results t1 and t2, t2 >= t1 holds.
+		 * \return A time point representing the current virtual time
+		 * of the instance active in the calling thread.
+		 * \post if now is called twice with results t1 and t2 in the same instance,
+		 * t2 >= t1 holds.
 		 */
 		static time_point now() noexcept;
+	};
+
+	/**
+	 * \brief time of a single scheduler.
+	 *
+	 * Several schedulers with their own instances can run in one process,
+	 * without affecting the time of each other.
+	 */
+	class instance
+	{
+	public:
+		instance() = default;
+		instance(const instance&) = delete;
+		instance& operator=(const instance&) = delete;
+
+		steady::time_point steady_now() const noexcept { return steady_time.load(); }
+		system::time_point system_now() const noexcept { return system_time.load(); }
+
+		/// advances steady and system time by d, \pre d >= 0
+		void advance(duration d) noexcept
+		{
+			steady_time.store(steady_time.load() + d);
+			system_time.store(system_time.load() + d);
+		}
+		/// sets the system time, the steady time is only advanced.
+		void set_time(system::time_point t) noexcept { system_time.store(t); }
 
 	private:
-		template<class T>
-		friend class master_clock;
+		std::atomic<steady::time_point> steady_time{steady::time_point{}};
+		std::atomic<system::time_point> system_time{system::time_point{}};
+	};
 
-		static void advance(duration d) noexcept;
+	/**
+	 * \brief makes an instance the clock of the calling thread for the lifetime of the scope.
+	 * Scopes can be nested, the previous instance is restored at the end of the scope.
+	 * A nullptr selects the process wide instance.
+	 */
+	class scope
+	{
+	public:
+		explicit scope(const instance* clock) noexcept;
+		~scope();
+		scope(const scope&) = delete;
+		scope& operator=(const scope&) = delete;
 
-		static std::atomic<time_point> current_time;
+	private:
+		const instance* previous;
 	};
+
+	/// returns the instance active in the calling thread.
+	static const instance& current() noexcept;
+	/// returns the process wide instance, which is controlled by master_clock.
+	static const instance& global() noexcept;
+
+private:
+	template<class T>
+	friend class master_clock;
+
+	static instance& global_instance() noexcept;
 };
 
 /**
@@ -135,22 +184,22 @@ public:
 	 */
 	static void advance() noexcept
 	{
-		steady_clock.advance(
-				std::chrono::duration_cast<virtual_clock::steady::duration>
-				(duration(1)));
-		system_clock.advance(
-				std::chrono::duration_cast<virtual_clock::system::duration>
-				(duration(1)));
+		virtual_clock::global_instance().advance(
+				std::chrono::duration_cast<virtual_clock::duration>(duration(1)));
+	}
+	/**
+	 * \brief advances clock by the given duration instead of a single tick
+	 * \pre d >= 0
+	 */
+	static void advance(virtual_clock::duration d) noexcept
+	{
+		virtual_clock::global_instance().advance(d);
 	}
 	static void set_time(virtual_clock::system::time_point r) noexcept
 	{
-		system_clock.set_time(r);
+		virtual_clock::global_instance().set_time(r);
 		//do not set time of steady clock, as it has only relative timings.
 	}
-
-private:
-	static virtual_clock::steady steady_clock;
-	static virtual_clock::system system_clock;
 };
 
 }  //namespace fc
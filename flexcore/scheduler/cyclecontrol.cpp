@@ -1,18 +1,30 @@
 #include <flexcore/scheduler/cyclecontrol.hpp>
 
 #include <algorithm>
+#include <cerrno>
+#include <future>
+#include <limits>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/strong_components.hpp>
+
+#include <time.h>
 
 namespace fc
 {
 namespace thread
 {
 
-using clock = master_clock<std::centi>;
 constexpr wall_clock::steady::duration cycle_control::min_tick_length;
 constexpr virtual_clock::steady::duration cycle_control::fast_tick;
 constexpr virtual_clock::steady::duration cycle_control::medium_tick;
 constexpr virtual_clock::steady::duration cycle_control::slow_tick;
+constexpr size_t cycle_control::max_wheel_size;
+constexpr int64_t cycle_control::max_hyperperiod;
+constexpr wall_clock::steady::duration precise_realtime_main_loop::default_spin_tail;
 
 cycle_control::cycle_control(std::unique_ptr<scheduler> scheduler,
 		 const std::shared_ptr<main_loop>& loop)
@@ -28,17 +40,89 @@ cycle_control::cycle_control(std::unique_ptr<scheduler> scheduler,
 void cycle_control::start()
 {
 	assert(!running);
+	if (!scheduler_->supports_affinity())
+		for (const auto& bucket : buckets)
+			for (const auto& task : bucket.tasks)
+				if (task.region && !task.region->get_affinity().empty())
+					throw std::invalid_argument{"region " + task.region->get_id().key
+							+ " is pinned to cpus, but the scheduler does not support affinity"};
+	// memory is locked and touched before any thread runs real-time work,
+	// thus page faults do not show up as jitter in the ticks.
+	if (realtime.lock_memory)
+		lock_memory();
+	if (realtime.prefault_heap != 0)
+		prefault_heap(realtime.prefault_heap);
+	if (realtime.worker_priority != 0)
+		scheduler_->set_worker_priority(realtime.worker_priority);
+
 	keep_working.store(true);
 	running = true;
+	std::promise<void> setup_done;
+	auto setup = setup_done.get_future();
 	//set the start time of the cycle to now.
 	// give the main thread some actual work to do (execute infinite main loop)
 	main_loop_thread = std::thread{
-		[&, this](){
+		[this, setup_done = std::move(setup_done)]() mutable {
+			FC_TRACE_REGISTER_THREAD();
+			try
+			{
+				if (realtime.main_loop_priority != 0)
+					set_current_thread_realtime_priority(realtime.main_loop_priority);
+				if (realtime.prefault_stack != 0)
+					prefault_stack(realtime.prefault_stack);
+				setup_done.set_value();
+			}
+			catch (...)
+			{
+				setup_done.set_exception(std::current_exception());
+				return;
+			}
+			const virtual_clock::scope clock_scope{clock.get()};
 			main_loop_->arm();
+			// constructed once, loop_body is called every tick.
+			const std::function<void(void)> tick = [this](){ work(); };
 			while(keep_working.load())
-				main_loop_->loop_body([this](){ work(); });
+				main_loop_->loop_body(tick);
 		}
 	};
+
+	try
+	{
+		setup.get();
+	}
+	catch (...)
+	{
+		keep_working.store(false);
+		main_loop_thread.join();
+		running = false;
+		throw;
+	}
+}
+
+const periodic_task& cycle_control::region_task(const parallel_region& region) const
+{
+	for (const auto& bucket : buckets)
+		for (const auto& task : bucket.tasks)
+			if (task.get_region() == &region)
+				return task;
+	throw std::invalid_argument{"region is not scheduled by this cycle_control"};
+}
+
+const task_statistics& cycle_control::region_statistics(const parallel_region& region) const
+{
+	return region_task(region).get_statistics();
+}
+
+const overrun_counters& cycle_control::region_overruns(const parallel_region& region) const
+{
+	return region_task(region).get_overrun_counters();
+}
+
+void cycle_control::set_realtime_settings(const realtime_settings& settings)
+{
+	if (running)
+		throw std::runtime_error{"Worker threads are already running"};
+	realtime = settings;
 }
 
 void cycle_control::stop()
@@ -47,15 +131,10 @@ void cycle_control::stop()
 	if (main_loop_thread.joinable())
 		main_loop_thread.join();
 	// wait for scheduled tasks to finish
-	auto wait_or_throw = [this](auto& task_vector)
-	{
-		for (auto& t : task_vector.tasks)
-			if (!t.wait_until_done(slow_tick))
+	for (auto& bucket : buckets)
+		for (auto& t : bucket.tasks)
+			if (!t.wait_until_done(std::max(bucket.tick, slow_tick)))
 				timeout_callback(t);
-	};
-	wait_or_throw(tasks_fast);
-	wait_or_throw(tasks_medium);
-	wait_or_throw(tasks_slow);
 	running = false;
 	//check post condition
 	assert(!keep_working.load());
@@ -72,42 +151,125 @@ bool cycle_control::store_exception(periodic_task&)
 
 void cycle_control::work()
 {
-	auto now = virtual_clock::steady::now().time_since_epoch();
-	auto run_if_due = [this, now](auto& task_vector)
+	// switch ticks are sent from here, thus regions see their own clock.
+	const virtual_clock::scope clock_scope{clock.get()};
+	if (!dependency_groups_valid)
+		update_dependency_groups();
+	collect_due_buckets(current_tick());
+	clock->advance(tick_length);
+	run_late_tasks();
+	for (const auto bucket : due_buckets)
+		if (!run_periodic_tasks(buckets[bucket]))
+			return;
+}
+
+void cycle_control::skip_idle_ticks(virtual_clock::steady::time_point limit)
+{
+	// late tasks are started in the first tick after they are done.
+	if (buckets.empty() || !late_tasks.empty())
+		return;
+	const int64_t tick = current_tick();
+	int64_t next = std::max<int64_t>(tick, limit.time_since_epoch() / tick_length);
+	for (const auto& bucket : buckets)
 	{
-		if (now % task_vector.tick == virtual_clock::duration::zero())
-			if (!run_periodic_tasks(task_vector))
-				return false;
-		return true;
-	};
-	clock::advance();
-	if (!run_if_due(tasks_fast)) return;
-	if (!run_if_due(tasks_medium)) return;
-	if (!run_if_due(tasks_slow)) return;
+		const int64_t period = bucket.tick / tick_length;
+		const int64_t phase = bucket.phase / tick_length;
+		next = std::min(next, tick + ((phase - tick) % period + period) % period);
+	}
+	if (next == tick)
+		return;
+
+	clock->advance(tick_length * (next - tick));
+	// no bucket is due in the skipped ticks, thus the wheel stays valid.
+	if (wheel_valid && due_tick == tick - 1)
+	{
+		due_tick = next - 1;
+		due_buckets.clear();
+	}
 }
 
 void cycle_control::wait_for_current_tasks()
 {
-	auto now = virtual_clock::steady::now().time_since_epoch();
-	auto wait_for_tasks = [this, now](auto& task_vector)
+	collect_due_buckets(current_tick());
+	for (const auto bucket : due_buckets)
 	{
-		if (now % task_vector.tick == virtual_clock::duration::zero())
-		{
-			for (auto& task : task_vector.tasks)
-				if (!task.wait_until_done(task_vector.tick))
+		auto& task_vector = buckets[bucket];
+		if (task_vector.barrier->wait_until(task_vector.start + task_vector.tick))
+			continue;
+		// overruns with other policies are handled when the tasks are due.
+		for (auto& task : task_vector.tasks)
+			if (!task.done() && task.get_overrun_policy().action == overrun_action::stop)
+			{
+				if (!timeout_callback(task))
 				{
-					if (!timeout_callback(task))
-					{
-						keep_working.store(false);
-						return false;
-					}
+					keep_working.store(false);
+					return;
 				}
-		}
-		return true;
-	};
-	if (!wait_for_tasks(tasks_slow)) return;
-	if (!wait_for_tasks(tasks_medium)) return;
-	if (!wait_for_tasks(tasks_fast)) return;
+			}
+	}
+}
+
+int64_t cycle_control::current_tick() const
+{
+	return clock->steady_now().time_since_epoch() / tick_length;
+}
+
+void cycle_control::collect_due_buckets(int64_t tick)
+{
+	if (wheel_valid && tick == due_tick)
+		return;
+	// the wheel is only up to date if the clock has advanced by exactly one tick.
+	if (!wheel_valid || tick != due_tick + 1)
+		rebuild_wheel(tick);
+
+	due_buckets.clear();
+	auto& slot = wheel[static_cast<size_t>(tick) % wheel.size()];
+	auto keep = slot.begin();
+	for (const auto& entry : slot)
+	{
+		if (entry.due_tick == tick)
+			due_buckets.push_back(entry.bucket);
+		else
+			*keep++ = entry; //bucket is due in a later turn of the wheel
+	}
+	slot.erase(keep, slot.end());
+	// buckets with shorter ticks are due earlier, dispatching them first
+	// gives earliest deadline first order in schedulers with fifo queues.
+	std::sort(due_buckets.begin(), due_buckets.end(), [this](size_t lhs, size_t rhs)
+	{
+		return buckets[lhs].tick != buckets[rhs].tick
+				? buckets[lhs].tick < buckets[rhs].tick
+				: lhs < rhs;
+	});
+
+	for (const auto bucket : due_buckets)
+	{
+		const int64_t next = tick + buckets[bucket].tick / tick_length;
+		wheel[static_cast<size_t>(next) % wheel.size()].push_back(timer_entry{bucket, next});
+	}
+	due_tick = tick;
+	wheel_valid = true;
+}
+
+void cycle_control::rebuild_wheel(int64_t tick)
+{
+	int64_t max_period = 1;
+	for (const auto& bucket : buckets)
+		max_period = std::max(max_period, bucket.tick / tick_length);
+	const size_t size = std::min(static_cast<size_t>(max_period), max_wheel_size);
+
+	wheel.resize(size);
+	for (auto& slot : wheel)
+		slot.clear();
+	for (size_t i = 0; i != buckets.size(); ++i)
+	{
+		const int64_t period = buckets[i].tick / tick_length;
+		const int64_t phase = buckets[i].phase / tick_length;
+		// buckets are due whenever the clock minus their phase is a multiple of their tick rate.
+		const int64_t next = tick + ((phase - tick) % period + period) % period;
+		wheel[static_cast<size_t>(next) % size].push_back(timer_entry{i, next});
+	}
+	due_buckets.reserve(buckets.size());
 }
 
 cycle_control::~cycle_control()
@@ -118,51 +280,411 @@ cycle_control::~cycle_control()
 
 bool cycle_control::run_periodic_tasks(tick_task_pair& tasks)
 {
+	if (!tasks.groups.empty())
+		return run_dependent_tasks(tasks);
+
 	assert(tasks.done_tasks.empty());
 	for (auto& task : tasks.tasks)
 	{
 		if (!task.done())
 		{
-			if (!timeout_callback(task))
-			{
-				keep_working.store(false);
+			if (!handle_overrun(tasks, task))
 				return false;
-			}
 			if (!task.done())
+			{
+				task.overruns->skipped_ticks.fetch_add(1, std::memory_order_relaxed);
 				continue;
+			}
 		}
 		tasks.done_tasks.emplace_back(task);
 	}
 
+	tasks.start = wall_clock::steady::now();
 	for (auto& task_ref : tasks.done_tasks)
 	{
 		periodic_task& task = task_ref.get();
 		assert(task.done());
+		task.begin_tick();
+		task.dispatched = tasks.start;
 		task.set_work_to_do(true);
 		task.send_switch_tick();
 	}
 	for (auto& task_ref : tasks.done_tasks)
 	{
 		periodic_task& task = task_ref.get();
-		scheduler_->add_task([&task] { task(); });
+		scheduler_->add_task([&task] { task(); }, task.get_properties());
 	}
 	tasks.done_tasks.clear();
 	return true;
 }
 
-void cycle_control::add_task(periodic_task task, virtual_clock::duration tick_rate)
+bool cycle_control::run_dependent_tasks(tick_task_pair& tasks)
+{
+	// successors of a task which is still running have not been started either,
+	// thus the whole bucket waits for the previous tick to be completed.
+	for (auto& task : tasks.tasks)
+	{
+		if (!task.done())
+		{
+			if (!handle_overrun(tasks, task))
+				return false;
+			if (!task.done())
+			{
+				task.overruns->skipped_ticks.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+	}
+
+	// all buffers, except the deferred links, are switched before any task is started.
+	tasks.start = wall_clock::steady::now();
+	for (auto& task : tasks.tasks)
+	{
+		task.begin_tick();
+		task.set_work_to_do(true);
+		task.send_switch_tick();
+	}
+	for (auto& group : tasks.groups)
+		group->pending.store(group->nr_of_predecessors);
+	for (auto& group : tasks.groups)
+		if (group->nr_of_predecessors == 0)
+			start_group(*group);
+	return true;
+}
+
+bool cycle_control::handle_overrun(tick_task_pair& tasks, periodic_task& task)
+{
+	task.overruns->misses.fetch_add(1, std::memory_order_relaxed);
+	++task.consecutive_misses;
+	const auto policy = task.get_overrun_policy();
+	switch (policy.action)
+	{
+	case overrun_action::stop:
+		break;
+	case overrun_action::skip_tick:
+		return true;
+	case overrun_action::run_when_done:
+		// tasks with dependencies are only started together with their bucket.
+		if (tasks.groups.empty() && !task.late)
+		{
+			task.late = true;
+			late_tasks.push_back(late_task{static_cast<size_t>(&tasks - buckets.data()), &task});
+		}
+		return true;
+	case overrun_action::shed_optional_work:
+		task.shed_next = true;
+		return true;
+	case overrun_action::escalate:
+		if (task.consecutive_misses < policy.max_misses)
+			return true;
+		task.consecutive_misses = 0;
+		break;
+	}
+
+	task.overruns->escalations.fetch_add(1, std::memory_order_relaxed);
+	if (!timeout_callback(task))
+	{
+		keep_working.store(false);
+		return false;
+	}
+	return true;
+}
+
+void cycle_control::run_late_tasks()
+{
+	if (late_tasks.empty())
+		return;
+	const auto now = wall_clock::steady::now();
+	auto keep = late_tasks.begin();
+	for (const auto& entry : late_tasks)
+	{
+		auto* task = entry.task;
+		if (!task->late)
+			continue; //task was started in its regular tick meanwhile
+		// buffers between regions with the same tick rate and phase only connect tasks
+		// of the same bucket, the switch tick would access them while such a task is running.
+		// if the bucket is due, the task is started in its regular tick instead.
+		const auto& bucket = buckets[entry.bucket];
+		const bool bucket_done = std::all_of(bucket.tasks.begin(), bucket.tasks.end(),
+				[](const periodic_task& t){ return t.done(); });
+		if (!bucket_done || std::find(due_buckets.begin(), due_buckets.end(), entry.bucket)
+				!= due_buckets.end())
+		{
+			*keep++ = entry;
+			continue;
+		}
+		task->overruns->late_starts.fetch_add(1, std::memory_order_relaxed);
+		task->begin_tick();
+		task->dispatched = now;
+		task->set_work_to_do(true);
+		task->send_switch_tick();
+		scheduler_->add_task([task] { (*task)(); }, task->get_properties());
+	}
+	late_tasks.erase(keep, late_tasks.end());
+}
+
+void cycle_control::start_group(dependency_group& group)
+{
+	group.running.store(group.tasks.size());
+	const auto now = wall_clock::steady::now();
+	for (auto* entry : group.tasks)
+		entry->task->dispatched = now;
+	// the producers of these links have finished and the consumers are not started yet,
+	// thus no other thread accesses their buffers.
+	for (auto* link : group.deferred_links)
+		link->fire();
+	for (auto* entry : group.tasks)
+	{
+		scheduler_->add_task([this, entry]
+		{
+			(*entry->task)([this, entry]{ finish_task(*entry->group); });
+		}, entry->task->get_properties());
+	}
+}
+
+void cycle_control::finish_task(dependency_group& group)
+{
+	if (group.running.fetch_sub(1) != 1)
+		return;
+	for (auto* successor : group.successors)
+		if (successor->pending.fetch_sub(1) == 1)
+			start_group(*successor);
+}
+
+void cycle_control::update_dependency_groups()
+{
+	using graph_t = boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS>;
+	for (auto& bucket : buckets)
+		for (auto& task : bucket.tasks)
+			if (task.region)
+				for (auto& link : task.region->ticks.links())
+					link.deferred = false;
+
+	for (auto& bucket : buckets)
+	{
+		bucket.groups.clear();
+		bucket.dependent_tasks.clear();
+
+		std::unordered_map<const parallel_region*, size_t> task_index;
+		for (size_t i = 0; i != bucket.tasks.size(); ++i)
+			if (const auto* region = bucket.tasks[i].get_region())
+				task_index.emplace(region, i);
+
+		graph_t graph(bucket.tasks.size());
+		for (const auto& dependency : region_dependencies)
+		{
+			const auto producer = task_index.find(dependency.producer);
+			const auto consumer = task_index.find(dependency.consumer);
+			if (producer != task_index.end() && consumer != task_index.end()
+					&& producer->second != consumer->second)
+				boost::add_edge(producer->second, consumer->second, graph);
+		}
+		if (boost::num_edges(graph) == 0)
+			continue;
+
+		// regions which depend on each other in a cycle form a single group.
+		std::vector<size_t> component(bucket.tasks.size());
+		const size_t nr_of_groups = boost::strong_components(graph,
+				boost::make_iterator_property_map(component.begin(),
+						boost::get(boost::vertex_index, graph)));
+
+		for (size_t i = 0; i != nr_of_groups; ++i)
+			bucket.groups.push_back(std::make_unique<dependency_group>());
+		bucket.dependent_tasks.reserve(bucket.tasks.size());
+		for (size_t i = 0; i != bucket.tasks.size(); ++i)
+		{
+			auto* group = bucket.groups[component[i]].get();
+			bucket.dependent_tasks.push_back(dependent_task{&bucket.tasks[i], group});
+			group->tasks.push_back(&bucket.dependent_tasks.back());
+		}
+
+		const auto edges = boost::edges(graph);
+		for (auto edge = edges.first; edge != edges.second; ++edge)
+		{
+			const auto from = component[boost::source(*edge, graph)];
+			const auto to = component[boost::target(*edge, graph)];
+			if (from != to)
+				bucket.groups[from]->successors.push_back(bucket.groups[to].get());
+		}
+		for (auto& group : bucket.groups)
+		{
+			auto& successors = group->successors;
+			std::sort(successors.begin(), successors.end());
+			successors.erase(std::unique(successors.begin(), successors.end()), successors.end());
+			for (auto* successor : successors)
+				++successor->nr_of_predecessors;
+		}
+
+		// links are deferred to the consumer, if it is started after the producer has finished.
+		for (auto& task : bucket.tasks)
+		{
+			if (!task.region)
+				continue;
+			for (auto& link : task.region->ticks.links())
+			{
+				const auto producer = task_index.find(link.producer);
+				const auto consumer = task_index.find(link.consumer);
+				if (producer == task_index.end() || consumer == task_index.end())
+					continue;
+				const auto* from = bucket.groups[component[producer->second]].get();
+				auto* to = bucket.groups[component[consumer->second]].get();
+				if (precedes(*from, *to))
+				{
+					link.deferred = true;
+					to->deferred_links.push_back(&link.switch_tick);
+				}
+			}
+		}
+	}
+	dependency_groups_valid = true;
+}
+
+bool cycle_control::precedes(const dependency_group& from, const dependency_group& to)
+{
+	std::vector<const dependency_group*> open_groups(
+			from.successors.begin(), from.successors.end());
+	std::vector<const dependency_group*> visited;
+	while (!open_groups.empty())
+	{
+		const auto* group = open_groups.back();
+		open_groups.pop_back();
+		if (group == &to)
+			return true;
+		if (std::find(visited.begin(), visited.end(), group) != visited.end())
+			continue;
+		visited.push_back(group);
+		open_groups.insert(open_groups.end(),
+				group->successors.begin(), group->successors.end());
+	}
+	return false;
+}
+
+void cycle_control::set_region_dependencies(std::vector<region_dependency> dependencies)
 {
 	if (running)
 		throw std::runtime_error{"Worker threads are already running"};
+	region_dependencies = std::move(dependencies);
+	dependency_groups_valid = false;
+}
 
-	if (tick_rate == slow_tick)
-		tasks_slow.tasks.emplace_back(std::move(task));
-	else if (tick_rate == medium_tick)
-		tasks_medium.tasks.emplace_back(std::move(task));
-	else if (tick_rate == fast_tick)
-		tasks_fast.tasks.emplace_back(std::move(task));
-	else
-		throw std::invalid_argument{"Unsupported tick_rate"};
+void cycle_control::check_tick_rate(virtual_clock::duration tick_rate) const
+{
+	if (tick_rate <= virtual_clock::duration::zero()
+			|| tick_rate % tick_length != virtual_clock::duration::zero())
+		throw std::invalid_argument{"Unsupported tick_rate, "
+				"needs to be a multiple of the min tick length"};
+}
+
+void cycle_control::add_task(periodic_task task, virtual_clock::duration tick_rate,
+		virtual_clock::duration phase)
+{
+	if (running)
+		throw std::runtime_error{"Worker threads are already running"};
+	check_tick_rate(tick_rate);
+	if (phase < virtual_clock::duration::zero() || phase >= tick_rate
+			|| phase % tick_length != virtual_clock::duration::zero())
+		throw std::invalid_argument{"Unsupported phase, needs to be a multiple "
+				"of the min tick length and smaller than the tick_rate"};
+
+	// adding the task might move other tasks.
+	for (const auto& entry : late_tasks)
+		entry.task->late = false;
+	late_tasks.clear();
+
+	auto bucket = std::find_if(buckets.begin(), buckets.end(),
+			[tick_rate, phase](const auto& b){ return b.tick == tick_rate && b.phase == phase; });
+	if (bucket == buckets.end())
+		bucket = buckets.insert(buckets.end(), tick_task_pair{tick_rate, phase});
+	if (task.region)
+		task.region->set_clock(clock);
+	bucket->tasks.emplace_back(std::move(task));
+	bucket->tasks.back().barrier = bucket->barrier.get();
+	bucket->tasks.back().clock = clock.get();
+	bucket->tasks.back().period = tick_rate;
+	wheel_valid = false;
+	dependency_groups_valid = false;
+}
+
+void cycle_control::set_min_tick_length(virtual_clock::duration length)
+{
+	if (running)
+		throw std::runtime_error{"Worker threads are already running"};
+	if (length <= virtual_clock::duration::zero())
+		throw std::invalid_argument{"min tick length needs to be positive"};
+	for (const auto& bucket : buckets)
+		if (bucket.tick % length != virtual_clock::duration::zero()
+				|| bucket.phase % length != virtual_clock::duration::zero())
+			throw std::invalid_argument{"tick rate or phase of existing task "
+					"is not a multiple of the min tick length"};
+
+	tick_length = length;
+	main_loop_->tick_length = length;
+	wheel_valid = false;
+}
+
+int64_t cycle_control::hyperperiod(int64_t period) const
+{
+	auto gcd = [](int64_t a, int64_t b)
+	{
+		while (b != 0)
+			a = std::exchange(b, a % b);
+		return a;
+	};
+	int64_t result = period;
+	for (const auto& bucket : buckets)
+	{
+		if (result >= max_hyperperiod)
+			break;
+		const int64_t bucket_period = bucket.tick / tick_length;
+		result = result / gcd(result, bucket_period) * bucket_period;
+	}
+	return std::min(result, max_hyperperiod);
+}
+
+std::vector<size_t> cycle_control::load_per_tick(int64_t nr_of_ticks) const
+{
+	std::vector<size_t> load(nr_of_ticks, 0);
+	for (const auto& bucket : buckets)
+	{
+		const int64_t period = bucket.tick / tick_length;
+		for (int64_t t = bucket.phase / tick_length; t < nr_of_ticks; t += period)
+			load[t] += bucket.tasks.size();
+	}
+	return load;
+}
+
+std::vector<size_t> cycle_control::slot_load() const
+{
+	return load_per_tick(hyperperiod(1));
+}
+
+virtual_clock::duration cycle_control::least_loaded_phase(virtual_clock::duration tick_rate) const
+{
+	check_tick_rate(tick_rate);
+	const int64_t period = tick_rate / tick_length;
+	const auto load = load_per_tick(hyperperiod(period));
+	const auto nr_of_ticks = static_cast<int64_t>(load.size());
+
+	int64_t best_phase = 0;
+	size_t best_peak = std::numeric_limits<size_t>::max();
+	size_t best_total = std::numeric_limits<size_t>::max();
+	for (int64_t phase = 0; phase != period; ++phase)
+	{
+		size_t peak = 0;
+		size_t total = 0;
+		for (int64_t t = phase; t < nr_of_ticks; t += period)
+		{
+			peak = std::max(peak, load[t]);
+			total += load[t];
+		}
+		if (peak < best_peak || (peak == best_peak && total < best_total))
+		{
+			best_phase = phase;
+			best_peak = peak;
+			best_total = total;
+		}
+	}
+	return best_phase * tick_length;
 }
 
 std::exception_ptr cycle_control::last_exception()
@@ -182,13 +704,62 @@ void cycle_control::set_main_loop(const std::shared_ptr<main_loop>& loop)
 	assert(loop);
 	main_loop_ = loop;
 	main_loop_->wait_for_current_tasks = [this](){ wait_for_current_tasks(); };
+	main_loop_->skip_idle_ticks = [this](auto limit){ skip_idle_ticks(limit); };
+	main_loop_->tick_length = tick_length;
 }
 
 void realtime_main_loop::loop_body(const std::function<void(void)>& work)
 {
-	epoch += cycle_control::min_tick_length;
+	epoch += tick_length;
 	work();
 	std::this_thread::sleep_until(epoch);
+	wakeup_lateness.record(wall_clock::steady::now() - epoch);
+}
+
+precise_realtime_main_loop::precise_realtime_main_loop(wall_clock::steady::duration tail)
+	: spin_tail(tail)
+{
+	assert(spin_tail >= wall_clock::steady::duration::zero());
+}
+
+void precise_realtime_main_loop::loop_body(const std::function<void(void)>& work)
+{
+	epoch += tick_length;
+	work();
+	const auto now = wall_clock::steady::now();
+	if (now >= epoch)
+	{
+		// the next tick starts right away, but the ticks after it keep to the tick boundaries.
+		wakeup_lateness.record(now - epoch);
+		epoch += (now - epoch) / tick_length * tick_length;
+		return;
+	}
+
+	wakeup_lateness.record(wait_until(epoch) - epoch);
+}
+
+wall_clock::steady::time_point precise_realtime_main_loop::wait_until(
+		wall_clock::steady::time_point deadline) const
+{
+	// steady_clock is based on CLOCK_MONOTONIC, thus its time points can be used directly.
+	const auto coarse_deadline = deadline - spin_tail;
+	if (wall_clock::steady::now() < coarse_deadline)
+	{
+		const auto since_epoch = coarse_deadline.time_since_epoch();
+		const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+		timespec wake_up{};
+		wake_up.tv_sec = static_cast<time_t>(seconds.count());
+		wake_up.tv_nsec = static_cast<long>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds).count());
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake_up, nullptr) == EINTR)
+		{
+		}
+	}
+
+	auto now = wall_clock::steady::now();
+	while (now < deadline)
+		now = wall_clock::steady::now();
+	return now;
 }
 
 void timewarp_main_loop::loop_body(const std::function<void(void)>& work)
@@ -199,12 +770,12 @@ void timewarp_main_loop::loop_body(const std::function<void(void)>& work)
 	std::unique_lock<std::mutex> lock(warp_mutex);
 	assert(warp_factor >= 0.0);
 	warp_signal.wait_until(lock,
-			epoch + cycle_control::min_tick_length * warp_factor,
+			epoch + tick_length * warp_factor,
 			[this]()
 			{
-				return wall_clock::steady::now() >= epoch + cycle_control::min_tick_length * warp_factor;
+				return wall_clock::steady::now() >= epoch + tick_length * warp_factor;
 			});
-	epoch += std::chrono::duration_cast<decltype(epoch)::duration>(cycle_control::min_tick_length * warp_factor);
+	epoch += std::chrono::duration_cast<decltype(epoch)::duration>(tick_length * warp_factor);
 }
 
 void timewarp_main_loop::set_warp_factor(double factor)
@@ -217,6 +788,8 @@ void timewarp_main_loop::set_warp_factor(double factor)
 
 void afap_main_loop::loop_body(const std::function<void(void)>& work)
 {
+	if (skip_idle)
+		skip_idle_ticks(virtual_clock::steady::time_point::max());
 	wait_for_current_tasks();
 	work();
 }
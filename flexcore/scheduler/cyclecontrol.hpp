@@ -4,10 +4,17 @@
 #include <flexcore/scheduler/clock.hpp>
 #include <flexcore/scheduler/scheduler.hpp>
 #include <flexcore/scheduler/parallelregion.hpp>
+#include <flexcore/scheduler/realtime.hpp>
+#include <flexcore/scheduler/detail/tick_barrier.hpp>
+#include <flexcore/scheduler/histogram.hpp>
+#include <flexcore/scheduler/overrun.hpp>
 #include <flexcore/pure/event_sources.hpp>
+#include <flexcore/utils/tracing/tracing.hpp>
 
+#include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
 #include <mutex>
 #include <memory>
@@ -20,18 +27,15 @@ namespace fc
 /// Classes and Functions related to the multithreading model of flexcore.
 namespace thread
 {
-namespace detail
-{
-struct condition_pair
-{
-	std::mutex mtx;
-	std::condition_variable cv;
-};
-}
+class cycle_control;
 
 /**
  * \brief class representing a task
  * which is executed with a fixed rate by the scheduler.
+ *
+ * Completion is tracked with an atomic flag.
+ * cycle_control attaches all tasks of a tick rate to a common tick_barrier,
+ * which is used to wait for the tasks.
  */
 struct periodic_task final
 {
@@ -42,42 +46,66 @@ struct periodic_task final
 	 */
 	explicit periodic_task(std::function<void(void)> job)
 		: work_to_do(false)
-		, sync(std::make_unique<detail::condition_pair>())
 		, work(std::move(job))
 		, work_start(wall_clock::steady::now())
 		, region(nullptr)
+		, statistics(std::make_unique<task_statistics>())
+		, overruns(std::make_unique<overrun_counters>())
 	{
 		assert(work);
 	}
 	/// Construct a periodic task executes work within a region
 	explicit periodic_task(const std::shared_ptr<parallel_region>& r) :
 				work_to_do(false),
-				sync(std::make_unique<detail::condition_pair>()),
 				work(r->ticks.in_work()),
 				work_start(wall_clock::steady::now()),
-				region(r)
+				region(r),
+				statistics(std::make_unique<task_statistics>()),
+				trace_name(trace::recorder::intern(r->get_id().key)),
+				overruns(std::make_unique<overrun_counters>())
 	{
 		assert(r != nullptr);
 		assert(work);
 	}
 
+	/// \pre other is not running
+	periodic_task(periodic_task&& other) noexcept
+		: work_to_do(other.work_to_do.load())
+		, barrier(other.barrier)
+		, clock(other.clock)
+		, work(std::move(other.work))
+		, work_start(other.work_start.load())
+		, region(std::move(other.region))
+		, statistics(std::move(other.statistics))
+		, period(other.period)
+		, dispatched(other.dispatched)
+		, trace_name(other.trace_name)
+		, overruns(std::move(other.overruns))
+		, consecutive_misses(other.consecutive_misses)
+		, shed_next(other.shed_next)
+		, late(other.late)
+	{
+	}
+
 	///returns true if all work in task is complete
-	bool done()
+	bool done() const
 	{
-		std::lock_guard<std::mutex> lock(sync->mtx);
-		return !work_to_do;
+		return !work_to_do.load();
 	}
 
 	///notify task if more work is to be done
 	void set_work_to_do(bool todo)
 	{
+		if (todo)
 		{
-			std::lock_guard<std::mutex> lock(sync->mtx);
-			work_to_do = todo;
+			if (barrier && !work_to_do.load())
+				barrier->add(1);
+			work_to_do.store(true);
+		}
+		else if (work_to_do.exchange(false) && barrier)
+		{
+			barrier->arrive();
 		}
-		// if we're done then notify all waiters
-		if (todo == false)
-			sync->cv.notify_all();
 	}
 
 	/** \brief waits for this task to be done, but only until the provided timeout.
@@ -85,12 +113,13 @@ struct periodic_task final
 	 */
 	bool wait_until_done(virtual_clock::steady::duration timeout)
 	{
-		std::unique_lock<std::mutex> lock(sync->mtx);
-		return sync->cv.wait_until(
-				lock,
-				work_start + timeout,
-				[this](){ return !this->work_to_do; }
-		);
+		const auto deadline = work_start.load() + timeout;
+		if (barrier)
+			return barrier->wait_until(deadline, [this](){ return done(); });
+
+		while (!done() && wall_clock::steady::now() < deadline)
+			std::this_thread::yield();
+		return done();
 	}
 
 	///trigger switch tick of associated parallel_region if it is registered.
@@ -100,22 +129,111 @@ struct periodic_task final
 			region->ticks.switch_buffers();
 	}
 
+	/// returns the associated parallel_region or nullptr if there is none.
+	const parallel_region* get_region() const { return region.get(); }
+
+	/// returns the timing of the work of the task, recorded while run by cycle_control.
+	const task_statistics& get_statistics() const { return *statistics; }
+
+	/// returns the overrun policy of the region, overrun_policy::stop for tasks without region.
+	overrun_policy get_overrun_policy() const
+	{
+		return region ? region->get_overrun_policy() : overrun_policy::stop();
+	}
+
+	/// returns the counters of the overruns of the task, \see overrun_policy
+	const overrun_counters& get_overrun_counters() const { return *overruns; }
+
+	/**
+	 * \brief returns the hints passed to the scheduler.
+	 * Tasks of regions run on the cpus of the region.
+	 * Tasks run by cycle_control are due at the start of their next tick,
+	 * the deadline is only passed on for regions with deadline scheduling enabled.
+	 * \see parallel_region::set_deadline_scheduling
+	 */
+	task_properties get_properties() const
+	{
+		task_properties properties;
+		if (!region)
+			return properties;
+		properties.cpus = &region->get_affinity();
+		if (period != virtual_clock::duration::zero() && region->get_deadline_scheduling())
+			properties.deadline = dispatched + period;
+		return properties;
+	}
+
 	void operator()()
 	{
-		work_start = wall_clock::steady::now();
+		(*this)([](){});
+	}
+
+	/// executes work and calls continuation before the task is marked as done.
+	template<class continuation_t>
+	void operator()(continuation_t continuation)
+	{
+		const virtual_clock::scope clock_scope{clock};
+		FC_TRACE_SPAN(trace_name, "task");
+		const auto start = wall_clock::steady::now();
+		work_start.store(start);
 		work();
+		// only tasks run by cycle_control have a deadline.
+		if (period != virtual_clock::duration::zero())
+		{
+			statistics->record(dispatched, start, wall_clock::steady::now(),
+					dispatched + period);
+		}
+		continuation();
 		set_work_to_do(false);
 	}
 private:
+	friend class cycle_control;
+
+	/// resets the overrun state before the next tick is started, called by cycle_control.
+	void begin_tick()
+	{
+		consecutive_misses = 0;
+		late = false;
+		if (region)
+			region->ticks.shed_optional = shed_next;
+		if (shed_next)
+			overruns->shed_ticks.fetch_add(1, std::memory_order_relaxed);
+		shed_next = false;
+	}
+
 	/// flag to check if work has already been executed this cycle.
-	bool work_to_do;
-	std::unique_ptr<detail::condition_pair> sync;
+	std::atomic<bool> work_to_do;
+	/// barrier of all tasks with the same tick rate, set by cycle_control
+	detail::tick_barrier* barrier = nullptr;
+	/// clock of the cycle_control, active while work is executed.
+	const virtual_clock::instance* clock = nullptr;
 	/// work to be done every cycle
 	std::function<void(void)> work;
 	/// start time of most recent work cycle
-	wall_clock::steady::time_point work_start;
+	std::atomic<wall_clock::steady::time_point> work_start;
 
 	std::shared_ptr<parallel_region> region;
+	std::unique_ptr<task_statistics> statistics;
+	/// tick rate of the task, set by cycle_control.
+	virtual_clock::duration period = virtual_clock::duration::zero();
+	/// time the task was handed to the scheduler in the current tick.
+	wall_clock::steady::time_point dispatched{};
+	/// name of the task in traces, the name of its region if it has one.
+	const char* trace_name = "periodic_task";
+
+	// overrun state, only accessed by the thread running cycle_control.
+	std::unique_ptr<overrun_counters> overruns;
+	size_t consecutive_misses = 0;
+	/// the next tick is started without the optional work of the region.
+	bool shed_next = false;
+	/// the task is waiting to start a missed tick, \see overrun_action::run_when_done
+	bool late = false;
+};
+
+/// dependency between two regions, data flows from producer to consumer.
+struct region_dependency
+{
+	const parallel_region* producer;
+	const parallel_region* consumer;
 };
 
 ///Abstract Base class for all main lopp classes.
@@ -128,17 +246,37 @@ public:
 	virtual void arm() = 0;
 
 	std::function<void(void)> wait_for_current_tasks{};
+	/// advances the virtual clock to the next tick in which any task is due, but not past limit.
+	std::function<void(virtual_clock::steady::time_point limit)> skip_idle_ticks{};
+	/// duration of a single iteration of the loop, set by cycle_control.
+	virtual_clock::steady::duration tick_length{parallel_region::min_tick_length};
+
+	/// returns how late the loop woke up for its ticks, empty for loops which do not sleep.
+	const latency_histogram& get_wakeup_lateness() const { return wakeup_lateness; }
+
+protected:
+	latency_histogram wakeup_lateness;
 };
 
 /**
  * \brief Main Loop which runs as fast as possible
+ *
+ * By default the virtual clock jumps over ticks in which no task is due,
+ * thus simulations of slow regions do not iterate over idle ticks.
+ * Tasks are still executed at the same virtual times.
  */
 class afap_main_loop final : public main_loop
 {
 public:
+	/// \param skip_idle if false the clock advances by a single tick per iteration.
+	explicit afap_main_loop(bool skip_idle = true) : skip_idle(skip_idle) {}
+
 	void loop_body(const std::function<void(void)>& work) override;
 
 	void arm() override {};
+
+private:
+	const bool skip_idle;
 };
 
 /**
@@ -155,6 +293,40 @@ private:
 	wall_clock::steady::time_point epoch{wall_clock::steady::now()};
 };
 
+/**
+ * \brief Main Loop which runs in realtime and wakes up precisely at the start of each tick.
+ *
+ * std::this_thread::sleep_until tends to oversleep by tens of microseconds.
+ * This loop sleeps with clock_nanosleep on an absolute deadline until spin_tail before the tick
+ * and busy waits for the remaining time.
+ * The lateness of the wake ups is recorded, \see cycle_control::main_loop_lateness
+ * If the work of a tick is not done before the next tick, the loop starts the next tick
+ * right away and then continues at the following tick boundary,
+ * instead of running the missed ticks back to back.
+ */
+class precise_realtime_main_loop final : public main_loop
+{
+public:
+	/// default duration of busy waiting before each tick.
+	static constexpr wall_clock::steady::duration default_spin_tail =
+			std::chrono::microseconds(100);
+
+	/// \pre spin_tail >= 0
+	explicit precise_realtime_main_loop(
+			wall_clock::steady::duration spin_tail = default_spin_tail);
+
+	void loop_body(const std::function<void(void)>& work) override;
+
+	void arm() override { epoch = wall_clock::steady::now(); }
+
+private:
+	/// sleeps and spins until deadline, returns the time of wake up.
+	wall_clock::steady::time_point wait_until(wall_clock::steady::time_point deadline) const;
+
+	const wall_clock::steady::duration spin_tail;
+	wall_clock::steady::time_point epoch{wall_clock::steady::now()};
+};
+
 /**
  * \brief Main Loop which runs variable speed.
  */
@@ -176,13 +348,25 @@ private:
 
 /**
  * \brief Controls timing and the execution of cyclic tasks in the scheduler.
+ *
+ * Tasks can run with any tick rate which is a multiple of the min tick length.
+ * The ticks of a task can be shifted by a phase offset,
+ * to spread tasks with long tick rates over the ticks of their period.
+ * Tasks with the same tick rate and phase are kept in a common bucket.
+ * The buckets are stored in a timer wheel indexed by the tick they are due next,
+ * thus a tick only visits the buckets which are actually due.
+ *
+ * If a task is due while its previous tick is still running,
+ * the overrun_policy of its region decides whether the tick is skipped, started late
+ * or the timeout callback is called, \see parallel_region::set_overrun_policy
+ *
  * Todo: allow to set virtual clock as control clock for replay as template parameter
- * todo: allow to set min_tick_length
  */
 class cycle_control
 {
 public:
 	//forward definitions of tick rates for use in scheduler
+	/// default length of a single tick, \see set_min_tick_length
 	static constexpr auto min_tick_length = parallel_region::min_tick_length;
 	static constexpr auto fast_tick =  parallel_region::fast_tick;
 	static constexpr auto medium_tick =  parallel_region::medium_tick;
@@ -216,7 +400,13 @@ public:
 
 	~cycle_control();
 
-	/// starts the main loop
+	/**
+	 * \brief starts the main loop
+	 * Applies the realtime_settings before the first tick,
+	 * throws std::system_error if they cannot be applied. The loop is not started then.
+	 * Throws std::invalid_argument if a region is pinned to cpus,
+	 * but the scheduler does not support affinity, \see scheduler::supports_affinity
+	 */
 	void start();
 	/// halts the main loop without joining worker threads
 	void stop();
@@ -224,16 +414,120 @@ public:
 	/// advances the clock by a single tick and executes all tasks for the cycle.
 	void work();
 
+	/**
+	 * \brief returns the timing of the work ticks of region.
+	 * Throws std::invalid_argument if region was not added to this cycle_control.
+	 */
+	const task_statistics& region_statistics(const parallel_region& region) const;
+
+	/**
+	 * \brief returns the counters of the overruns of region.
+	 * Throws std::invalid_argument if region was not added to this cycle_control.
+	 */
+	const overrun_counters& region_overruns(const parallel_region& region) const;
+
+	/// returns how late the main loop woke up for its ticks.
+	const latency_histogram& main_loop_lateness() const
+	{
+		return main_loop_->get_wakeup_lateness();
+	}
+
+	/**
+	 * \brief returns the virtual clock of this cycle_control.
+	 * The clock is active in the main loop and in all tasks,
+	 * thus virtual_clock::steady::now() returns its time there.
+	 * Regions added to the cycle_control refer to it as well, \see parallel_region::get_clock
+	 */
+	const virtual_clock::instance& get_clock() const { return *clock; }
+
+	/**
+	 * \brief advances the virtual clock to the next tick in which any task is due.
+	 * Does nothing if tasks are due in the current tick or no tasks exist.
+	 * \param limit the clock is not advanced beyond the tick containing limit.
+	 */
+	void skip_idle_ticks(
+			virtual_clock::steady::time_point limit = virtual_clock::steady::time_point::max());
+
 	/**
 	 * \brief adds a new cyclic task with the given tick_rate.
 	 * Tasks can only be added as long as the cycle_control has not been started. A
 	 * std::runtime_error exception will be thrown if an attempt is made to add a task to a running
 	 * cycle_control.
 	 *
+	 * \param task task to execute
+	 * \param tick_rate period of the task
+	 * \param phase the task is due whenever the clock minus phase is a multiple of tick_rate.
+	 * \pre cycle_control is not running
+	 * \pre tick_rate is a positive multiple of the min tick length
+	 * and phase is a multiple of the min tick length in [0, tick_rate),
+	 * throws std::invalid_argument otherwise.
+	 * \post list of tasks for given tick_rate and phase is not empty
+	 */
+	void add_task(periodic_task task, virtual_clock::duration tick_rate,
+			virtual_clock::duration phase = virtual_clock::duration::zero());
+
+	/**
+	 * \brief sets the duration of a single tick of the main loop.
+	 * Throws std::runtime_error if cycle_control is running
+	 * and std::invalid_argument if length is not positive
+	 * or the tick rate of an already added task is not a multiple of length.
+	 *
+	 * \pre cycle_control is not running
+	 * \post get_min_tick_length() == length
+	 */
+	void set_min_tick_length(virtual_clock::duration length);
+	virtual_clock::duration get_min_tick_length() const { return tick_length; }
+
+	/**
+	 * \brief sets real-time priorities and memory locking, applied by start().
+	 * Throws std::runtime_error if cycle_control is running.
+	 * \pre cycle_control is not running
+	 */
+	void set_realtime_settings(const realtime_settings& settings);
+	const realtime_settings& get_realtime_settings() const { return realtime; }
+
+	/**
+	 * \brief starts regions which are due in the same tick in the order of their dependencies.
+	 *
+	 * By default all due regions are started at once.
+	 * With dependencies, a region is only started after all regions it depends on
+	 * have finished their work in the current tick, while independent regions still run in parallel.
+	 * All switch ticks of the regions are still sent by the main loop before any region is started,
+	 * only the buffers from a region to a region started after it are switched,
+	 * when the receiving region is started, \see region_link.
+	 * Thus data flows through a chain of such regions within a single tick.
+	 * Regions which depend on each other in a cycle are started together.
+	 * Dependencies between regions with different tick rates are ignored.
+	 * An empty list restores the default.
+	 *
+	 * Throws std::runtime_error if cycle_control is running.
 	 * \pre cycle_control is not running
-	 * \post list of tasks for given tick_rate is not empty
 	 */
-	void add_task(periodic_task task, virtual_clock::duration tick_rate);
+	void set_region_dependencies(std::vector<region_dependency> dependencies);
+
+	/**
+	 * \brief returns the number of tasks which are due in every tick of the hyperperiod.
+	 *
+	 * The hyperperiod is the least common multiple of all tick rates in ticks,
+	 * but at most max_hyperperiod ticks.
+	 * Element i is the number of tasks due in the ticks t with t % size() == i,
+	 * where t is the virtual time divided by the min tick length.
+	 */
+	std::vector<size_t> slot_load() const;
+
+	/**
+	 * \brief returns the phase for a new task with tick_rate which causes the least load.
+	 *
+	 * Picks the phase where the highest number of tasks due in a single tick is lowest,
+	 * ties are broken by the total number of tasks due in the ticks of the new task.
+	 * \pre tick_rate is a positive multiple of the min tick length,
+	 * throws std::invalid_argument otherwise.
+	 * \post result is a multiple of the min tick length in [0, tick_rate)
+	 */
+	virtual_clock::duration least_loaded_phase(virtual_clock::duration tick_rate) const;
+
+	/// upper limit of the number of ticks considered by slot_load and least_loaded_phase.
+	static constexpr int64_t max_hyperperiod = 1 << 16;
 	/// returns the number of currently scheduled tasks
 	size_t nr_of_tasks() const { return scheduler_->nr_of_waiting_tasks(); }
 
@@ -249,20 +543,113 @@ public:
 	void set_main_loop(const std::shared_ptr<main_loop>& loop);
 
 private:
+	struct dependency_group;
+
+	struct dependent_task
+	{
+		periodic_task* task;
+		dependency_group* group;
+	};
+
+	/// tasks which are started together once all of their predecessors are done.
+	struct dependency_group
+	{
+		std::vector<dependent_task*> tasks{};
+		std::vector<dependency_group*> successors{};
+		size_t nr_of_predecessors = 0;
+		/// number of predecessors which have not finished in the current tick.
+		std::atomic<size_t> pending{0};
+		/// number of tasks in this group which have not finished in the current tick.
+		std::atomic<size_t> running{0};
+		/// links to the regions of this group from regions of preceding groups.
+		std::vector<pure::event_source<void>*> deferred_links{};
+	};
+
 	struct tick_task_pair
 	{
 		virtual_clock::steady::duration tick;
+		virtual_clock::steady::duration phase;
 		std::vector<periodic_task> tasks{};
 		std::vector<std::reference_wrapper<periodic_task>> done_tasks{};
+		/// counts the tasks which have not finished their work yet.
+		std::unique_ptr<detail::tick_barrier> barrier = std::make_unique<detail::tick_barrier>();
+		/// time at which the tasks were started most recently.
+		wall_clock::steady::time_point start{};
+		/// tasks in the same order as in tasks, empty if no dependencies exist between them.
+		std::vector<dependent_task> dependent_tasks{};
+		std::vector<std::unique_ptr<dependency_group>> groups{};
+	};
+
+	/// entry in the timer wheel, bucket is an index into buckets.
+	struct timer_entry
+	{
+		size_t bucket;
+		int64_t due_tick;
+	};
+
+	/// task waiting to start a missed tick, bucket is the index of its bucket.
+	struct late_task
+	{
+		size_t bucket;
+		periodic_task* task;
 	};
 
 	/// runs the tasks in this vector; returns false if any task is not done, true otherwise
 	bool run_periodic_tasks(tick_task_pair& tasks);
+	/**
+	 * \brief applies the overrun policy to task, which is due but not done.
+	 * \return false if the cycle is to be stopped.
+	 */
+	bool handle_overrun(tick_task_pair& tasks, periodic_task& task);
+	/**
+	 * \brief starts late tasks, once all tasks of their bucket are finished.
+	 * Called before any bucket of the tick is started, \see overrun_action::run_when_done
+	 */
+	void run_late_tasks();
+	/// returns the task of region, throws std::invalid_argument if there is none.
+	const periodic_task& region_task(const parallel_region& region) const;
+	/// runs the tasks in this vector in the order of their dependencies
+	bool run_dependent_tasks(tick_task_pair& tasks);
+	void start_group(dependency_group& group);
+	/// called by every task of group when it is finished, starts successors of the group.
+	void finish_task(dependency_group& group);
+	/// builds dependency groups of all buckets from region_dependencies.
+	void update_dependency_groups();
+	/// returns true if to is started after from has finished.
+	static bool precedes(const dependency_group& from, const dependency_group& to);
 	void wait_for_current_tasks();
-
-	tick_task_pair tasks_slow{slow_tick};
-	tick_task_pair tasks_medium{medium_tick};
-	tick_task_pair tasks_fast{fast_tick};
+	/// returns the index of the current tick, counted in multiples of the tick length.
+	int64_t current_tick() const;
+	/// fills due_buckets with the buckets due at tick and reschedules them in the wheel.
+	void collect_due_buckets(int64_t tick);
+	/// rebuilds the timer wheel, such that every bucket is due next at or after tick.
+	void rebuild_wheel(int64_t tick);
+	/// returns the least common multiple of period and all tick rates in ticks, capped.
+	int64_t hyperperiod(int64_t period) const;
+	/// returns the number of tasks due at each of the first nr_of_ticks ticks.
+	std::vector<size_t> load_per_tick(int64_t nr_of_ticks) const;
+	/// throws std::invalid_argument if tick_rate is no valid tick rate for a task.
+	void check_tick_rate(virtual_clock::duration tick_rate) const;
+
+	/// largest number of slots in the wheel, buckets with longer periods wrap around.
+	static constexpr size_t max_wheel_size = 1024;
+
+	virtual_clock::duration tick_length{min_tick_length};
+	/// time of this cycle_control, independent of other cycle_controls in the process.
+	std::shared_ptr<virtual_clock::instance> clock = std::make_shared<virtual_clock::instance>();
+	/// one bucket for every distinct tick rate.
+	std::vector<tick_task_pair> buckets;
+	/// slot i contains the buckets due at ticks t with t % wheel.size() == i.
+	std::vector<std::vector<timer_entry>> wheel;
+	/// buckets due at due_tick, valid if wheel_valid is true.
+	std::vector<size_t> due_buckets;
+	/// tasks waiting to start a missed tick.
+	std::vector<late_task> late_tasks;
+	int64_t due_tick = 0;
+	bool wheel_valid = false;
+	std::vector<region_dependency> region_dependencies;
+	bool dependency_groups_valid = true;
+	realtime_settings realtime;
 	std::unique_ptr<scheduler> scheduler_;
 	std::atomic<bool> keep_working{false};
 	bool running = false;
@@ -292,6 +679,8 @@ inline cycle_control::cycle_control(std::unique_ptr<scheduler> scheduler,
 	assert(main_loop_);
 	assert(timeout_callback);
 	main_loop_->wait_for_current_tasks = [this](){ wait_for_current_tasks(); };
+	main_loop_->skip_idle_ticks = [this](auto limit){ skip_idle_ticks(limit); };
+	main_loop_->tick_length = tick_length;
 }
 
 } /* namespace thread */
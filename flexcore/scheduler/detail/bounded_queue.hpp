@@ -0,0 +1,129 @@
+#ifndef SRC_SCHEDULER_DETAIL_BOUNDED_QUEUE_HPP_
+#define SRC_SCHEDULER_DETAIL_BOUNDED_QUEUE_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace fc
+{
+namespace thread
+{
+namespace detail
+{
+
+/**
+ * \brief lock free queue with fixed capacity for multiple producers and multiple consumers.
+ *
+ * Ring buffer where every cell carries a sequence number,
+ * which tells producers and consumers if the cell is ready to be written or read.
+ * Producers and consumers only synchronize on the cells they access
+ * and the position counters. See Dmitry Vyukov's bounded MPMC queue.
+ *
+ * \tparam T type of stored elements, needs to be default constructible and move assignable.
+ * \invariant capacity is a power of two.
+ */
+template<class T>
+class bounded_mpmc_queue
+{
+public:
+	/// \pre capacity is a power of two and > 1
+	explicit bounded_mpmc_queue(size_t capacity)
+		: cells(new cell[capacity])
+		, mask(capacity - 1)
+	{
+		assert(capacity > 1);
+		assert((capacity & mask) == 0);
+		for (size_t i = 0; i != capacity; ++i)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	bounded_mpmc_queue(const bounded_mpmc_queue&) = delete;
+	bounded_mpmc_queue& operator=(const bounded_mpmc_queue&) = delete;
+
+	/**
+	 * \brief moves value into the queue if it is not full.
+	 * \returns true if value was added, value is left untouched otherwise.
+	 */
+	bool try_push(T& value)
+	{
+		cell* target = nullptr;
+		size_t pos = enqueue.value.load(std::memory_order_relaxed);
+		while (true)
+		{
+			target = &cells[pos & mask];
+			const size_t seq = target->sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+			if (diff == 0)
+			{
+				if (enqueue.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false; //queue is full
+			else
+				pos = enqueue.value.load(std::memory_order_relaxed);
+		}
+		target->data = std::move(value);
+		target->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * \brief moves the oldest element out of the queue into value if the queue is not empty.
+	 * \returns true if an element was taken.
+	 */
+	bool try_pop(T& value)
+	{
+		cell* source = nullptr;
+		size_t pos = dequeue.value.load(std::memory_order_relaxed);
+		while (true)
+		{
+			source = &cells[pos & mask];
+			const size_t seq = source->sequence.load(std::memory_order_acquire);
+			const auto diff =
+					static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+			if (diff == 0)
+			{
+				if (dequeue.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false; //queue is empty
+			else
+				pos = dequeue.value.load(std::memory_order_relaxed);
+		}
+		value = std::move(source->data);
+		source->sequence.store(pos + mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t capacity() const { return mask + 1; }
+
+private:
+	struct cell
+	{
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	/// position counter filling a whole cache line, producers and consumers do not share lines.
+	struct padded_position
+	{
+		std::atomic<size_t> value{0};
+		char padding[64 - sizeof(std::atomic<size_t>)];
+	};
+
+	std::unique_ptr<cell[]> cells;
+	const size_t mask;
+	padded_position enqueue;
+	padded_position dequeue;
+};
+
+} // namespace detail
+} // namespace thread
+} // namespace fc
+
+#endif /* SRC_SCHEDULER_DETAIL_BOUNDED_QUEUE_HPP_ */
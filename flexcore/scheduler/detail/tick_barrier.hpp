@@ -0,0 +1,96 @@
+#ifndef SRC_SCHEDULER_DETAIL_TICK_BARRIER_HPP_
+#define SRC_SCHEDULER_DETAIL_TICK_BARRIER_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace fc
+{
+namespace thread
+{
+namespace detail
+{
+
+/**
+ * \brief counts the tasks of a tick which have not finished yet.
+ *
+ * Tasks signal their completion with a single atomic decrement.
+ * The mutex and condition variable are only touched if a thread is actually waiting,
+ * thus ticks where all tasks finish in time are free of locks.
+ */
+class tick_barrier
+{
+public:
+	tick_barrier() = default;
+	tick_barrier(const tick_barrier&) = delete;
+	tick_barrier& operator=(const tick_barrier&) = delete;
+
+	/// registers nr_of_tasks additional unfinished tasks.
+	void add(size_t nr_of_tasks) noexcept
+	{
+		pending.fetch_add(nr_of_tasks);
+	}
+
+	/**
+	 * \brief marks a single task as finished and wakes up waiting threads.
+	 * \pre number of unfinished tasks > 0
+	 */
+	void arrive()
+	{
+		const auto previous = pending.fetch_sub(1);
+		assert(previous != 0);
+		(void)previous;
+		if (waiters.load() == 0)
+			return;
+		// lock to make sure waiters are either before their check or already waiting.
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+		}
+		cv.notify_all();
+	}
+
+	/// returns true if all tasks have finished.
+	bool done() const noexcept { return pending.load() == 0; }
+
+	/**
+	 * \brief waits until condition is true or deadline has passed.
+	 * condition is checked again every time a task arrives.
+	 * \return result of condition
+	 */
+	template<class time_point_t, class condition_t>
+	bool wait_until(const time_point_t& deadline, condition_t condition)
+	{
+		if (condition())
+			return true;
+		waiters.fetch_add(1);
+		bool result = false;
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			result = cv.wait_until(lock, deadline, condition);
+		}
+		waiters.fetch_sub(1);
+		return result;
+	}
+
+	/// waits until all tasks have finished or deadline has passed, returns done()
+	template<class time_point_t>
+	bool wait_until(const time_point_t& deadline)
+	{
+		return wait_until(deadline, [this](){ return done(); });
+	}
+
+private:
+	std::atomic<size_t> pending{0};
+	std::atomic<size_t> waiters{0};
+	std::mutex mtx;
+	std::condition_variable cv;
+};
+
+} // namespace detail
+} // namespace thread
+} // namespace fc
+
+#endif /* SRC_SCHEDULER_DETAIL_TICK_BARRIER_HPP_ */
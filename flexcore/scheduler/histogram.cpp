@@ -0,0 +1,106 @@
+#include <flexcore/scheduler/histogram.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace fc
+{
+namespace thread
+{
+
+constexpr size_t latency_histogram::sub_bucket_bits;
+constexpr size_t latency_histogram::sub_buckets;
+constexpr size_t latency_histogram::nr_of_buckets;
+
+size_t latency_histogram::bucket_index(uint64_t nanoseconds) noexcept
+{
+	if (nanoseconds < sub_buckets)
+		return static_cast<size_t>(nanoseconds);
+	// the highest set bit selects the group, the following bits the bucket within the group.
+	const size_t exponent = 63 - static_cast<size_t>(__builtin_clzll(nanoseconds));
+	const size_t shift = exponent - sub_bucket_bits;
+	const size_t mantissa = static_cast<size_t>(nanoseconds >> shift) & (sub_buckets - 1);
+	return (shift + 1) * sub_buckets + mantissa;
+}
+
+uint64_t latency_histogram::bucket_limit(size_t index) noexcept
+{
+	if (index < sub_buckets)
+		return index;
+	const size_t shift = index / sub_buckets - 1;
+	const uint64_t mantissa = index % sub_buckets;
+	const uint64_t lower = (sub_buckets + mantissa) << shift;
+	return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void latency_histogram::record(duration d) noexcept
+{
+	const uint64_t value = d.count() > 0 ? static_cast<uint64_t>(d.count()) : 0;
+	buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+	total.fetch_add(1, std::memory_order_relaxed);
+	sum.fetch_add(value, std::memory_order_relaxed);
+
+	auto current = smallest.load(std::memory_order_relaxed);
+	while (value < current && !smallest.compare_exchange_weak(current, value,
+			std::memory_order_relaxed))
+	{
+	}
+	current = largest.load(std::memory_order_relaxed);
+	while (value > current && !largest.compare_exchange_weak(current, value,
+			std::memory_order_relaxed))
+	{
+	}
+}
+
+latency_histogram::duration latency_histogram::min() const noexcept
+{
+	if (count() == 0)
+		return duration::zero();
+	return duration{static_cast<duration::rep>(smallest.load(std::memory_order_relaxed))};
+}
+
+latency_histogram::duration latency_histogram::max() const noexcept
+{
+	return duration{static_cast<duration::rep>(largest.load(std::memory_order_relaxed))};
+}
+
+latency_histogram::duration latency_histogram::mean() const noexcept
+{
+	const auto nr = count();
+	if (nr == 0)
+		return duration::zero();
+	return duration{static_cast<duration::rep>(sum.load(std::memory_order_relaxed) / nr)};
+}
+
+latency_histogram::duration latency_histogram::percentile(double percent) const noexcept
+{
+	assert(percent >= 0.0 && percent <= 100.0);
+	const auto nr = count();
+	if (nr == 0)
+		return duration::zero();
+	const auto rank = std::max<uint64_t>(1,
+			static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(nr))));
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i != nr_of_buckets; ++i)
+	{
+		seen += buckets[i].load(std::memory_order_relaxed);
+		if (seen >= rank)
+			return std::min(duration{static_cast<duration::rep>(bucket_limit(i))}, max());
+	}
+	return max();
+}
+
+void latency_histogram::reset() noexcept
+{
+	for (auto& bucket : buckets)
+		bucket.store(0, std::memory_order_relaxed);
+	total.store(0, std::memory_order_relaxed);
+	sum.store(0, std::memory_order_relaxed);
+	smallest.store(UINT64_MAX, std::memory_order_relaxed);
+	largest.store(0, std::memory_order_relaxed);
+}
+
+} // namespace thread
+} // namespace fc
@@ -0,0 +1,98 @@
+#ifndef SRC_SCHEDULER_HISTOGRAM_HPP_
+#define SRC_SCHEDULER_HISTOGRAM_HPP_
+
+#include <flexcore/scheduler/clock.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace fc
+{
+namespace thread
+{
+
+/**
+ * \brief lock free histogram of durations with logarithmic buckets.
+ *
+ * Durations are stored in nanoseconds with a relative precision of 1/16,
+ * similar to HdrHistogram.
+ * Recording only uses relaxed atomic increments, thus histograms can be written
+ * concurrently from several threads and read while they are written.
+ * Results read during recording reflect a recent, not necessarily consistent, state.
+ */
+class latency_histogram
+{
+public:
+	using duration = wall_clock::steady::duration;
+
+	latency_histogram() = default;
+	latency_histogram(const latency_histogram&) = delete;
+	latency_histogram& operator=(const latency_histogram&) = delete;
+
+	/// records a single duration, negative durations are recorded as zero.
+	void record(duration d) noexcept;
+
+	/// number of recorded durations
+	uint64_t count() const noexcept { return total.load(std::memory_order_relaxed); }
+	/// smallest recorded duration, zero if nothing was recorded.
+	duration min() const noexcept;
+	/// largest recorded duration, zero if nothing was recorded.
+	duration max() const noexcept;
+	/// average of all recorded durations, zero if nothing was recorded.
+	duration mean() const noexcept;
+	/**
+	 * \brief returns a duration which is larger or equal to percent percent of all durations.
+	 * The result is exact up to the precision of the buckets.
+	 * \pre 0 <= percent <= 100
+	 */
+	duration percentile(double percent) const noexcept;
+
+	/// removes all recorded durations, \pre no concurrent calls to record
+	void reset() noexcept;
+
+private:
+	static constexpr size_t sub_bucket_bits = 4;
+	static constexpr size_t sub_buckets = size_t{1} << sub_bucket_bits;
+	static constexpr size_t nr_of_buckets = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+	static size_t bucket_index(uint64_t nanoseconds) noexcept;
+	/// largest value which is stored in bucket index
+	static uint64_t bucket_limit(size_t index) noexcept;
+
+	std::array<std::atomic<uint64_t>, nr_of_buckets> buckets{};
+	std::atomic<uint64_t> total{0};
+	std::atomic<uint64_t> sum{0};
+	std::atomic<uint64_t> smallest{UINT64_MAX};
+	std::atomic<uint64_t> largest{0};
+};
+
+/// timing of the work of a single periodic_task, recorded every tick.
+struct task_statistics
+{
+	/// duration of the work of the task.
+	latency_histogram work_duration;
+	/// time between the task was handed to the scheduler and the start of its work.
+	latency_histogram dispatch_latency;
+	/// time the task finished after its deadline, which is the start of its next tick.
+	latency_histogram lateness;
+	/// number of ticks in which the task finished after its deadline.
+	std::atomic<uint64_t> overruns{0};
+
+	/// records a single execution of the task.
+	void record(wall_clock::steady::time_point dispatched, wall_clock::steady::time_point start,
+			wall_clock::steady::time_point end, wall_clock::steady::time_point deadline) noexcept
+	{
+		work_duration.record(end - start);
+		dispatch_latency.record(start - dispatched);
+		lateness.record(end - deadline);
+		if (end > deadline)
+			overruns.fetch_add(1, std::memory_order_relaxed);
+	}
+};
+
+} // namespace thread
+} // namespace fc
+
+#endif /* SRC_SCHEDULER_HISTOGRAM_HPP_ */
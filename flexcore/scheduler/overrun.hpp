@@ -0,0 +1,77 @@
+#ifndef SRC_SCHEDULER_OVERRUN_HPP_
+#define SRC_SCHEDULER_OVERRUN_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace fc
+{
+namespace thread
+{
+
+/**
+ * \brief reaction of cycle_control to a task which is due again,
+ * while the work of its previous tick is still running.
+ */
+enum class overrun_action
+{
+	/// calls the timeout callback of cycle_control, which stops the cycle by default.
+	stop,
+	/// skips the tick, the task runs again in its next regular tick.
+	skip_tick,
+	/**
+	 * \brief starts the missed tick in the first tick after the running tick is finished.
+	 * The missed tick waits for all tasks with the same tick rate and phase as well,
+	 * since they might be connected to the task by buffers, which are switched on its start.
+	 */
+	run_when_done,
+	/// skips the tick and suppresses the optional work of the region in the next tick.
+	shed_optional_work,
+	/// skips the tick and calls the timeout callback after max_misses consecutive misses.
+	escalate
+};
+
+/// configures how cycle_control handles overruns of the tasks of a region.
+struct overrun_policy
+{
+	overrun_action action = overrun_action::stop;
+	/// number of consecutive misses tolerated by overrun_action::escalate.
+	size_t max_misses = 1;
+
+	static overrun_policy stop() { return overrun_policy{}; }
+	static overrun_policy skip_tick() { return overrun_policy{overrun_action::skip_tick, 1}; }
+	static overrun_policy run_when_done()
+	{
+		return overrun_policy{overrun_action::run_when_done, 1};
+	}
+	static overrun_policy shed_optional_work()
+	{
+		return overrun_policy{overrun_action::shed_optional_work, 1};
+	}
+	/// \pre misses > 0
+	static overrun_policy escalate(size_t misses)
+	{
+		return overrun_policy{overrun_action::escalate, misses};
+	}
+};
+
+/// counts the overruns of a task and the reactions to them, can be read while the cycle runs.
+struct overrun_counters
+{
+	/// ticks in which the task was due while its previous tick was still running.
+	std::atomic<uint64_t> misses{0};
+	/// ticks which were not executed due to an overrun.
+	std::atomic<uint64_t> skipped_ticks{0};
+	/// missed ticks which were started after the previous tick finished.
+	std::atomic<uint64_t> late_starts{0};
+	/// ticks which were executed without the optional work.
+	std::atomic<uint64_t> shed_ticks{0};
+	/// calls of the timeout callback.
+	std::atomic<uint64_t> escalations{0};
+};
+
+} // namespace thread
+} // namespace fc
+
+#endif /* SRC_SCHEDULER_OVERRUN_HPP_ */
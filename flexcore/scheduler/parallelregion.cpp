@@ -26,10 +26,17 @@ virtual_clock::steady::duration parallel_region::get_duration() const
 	return tick_duration;
 }
 
-parallel_region::parallel_region(std::string id_, virtual_clock::steady::duration tick_rate) :
+virtual_clock::steady::duration parallel_region::get_phase() const
+{
+	return tick_phase;
+}
+
+parallel_region::parallel_region(std::string id_, virtual_clock::steady::duration tick_rate,
+		virtual_clock::steady::duration phase) :
 		ticks(),
 		id({std::move(id_)}),
-		tick_duration(tick_rate)
+		tick_duration(tick_rate),
+		tick_phase(phase)
 {
 	static_assert(thread::cycle_control::slow_tick == std::chrono::seconds(1),
 			"Slow tick is not 1s, the default constructor parameter of parallel_region needs adaption");
@@ -46,9 +53,19 @@ pure::event_source<void>& parallel_region::switch_tick()
 	return ticks.switch_tick();
 }
 
+pure::concurrent_event_source<void>& parallel_region::reclaim_tick()
+{
+	return ticks.reclaim_tick();
+}
+
 pure::event_source<void>& parallel_region::work_tick()
 {
 	return ticks.work_tick();
 }
 
+pure::event_source<void>& parallel_region::optional_work_tick()
+{
+	return ticks.optional_work_tick();
+}
+
 } /* namespace fc */
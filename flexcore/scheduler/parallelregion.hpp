@@ -8,10 +8,20 @@
 #ifndef SRC_SCHEDULER_PARALLELREGION_HPP_
 #define SRC_SCHEDULER_PARALLELREGION_HPP_
 
+#include <flexcore/pure/concurrent_event_source.hpp>
 #include <flexcore/pure/event_sources.hpp>
 #include <flexcore/scheduler/clock.hpp>
+#include <flexcore/scheduler/affinity.hpp>
+#include <flexcore/scheduler/overrun.hpp>
+#include <flexcore/utils/tracing/tracing.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
 #include <string>
 #include <memory>
+#include <utility>
 
 namespace fc
 {
@@ -25,36 +35,128 @@ struct region_id
 
 bool operator==(const region_id& lhs, const region_id& rhs);
 
+class parallel_region;
+
+/**
+ * \brief switch tick of the buffers from one region to another with the same tick rate and phase.
+ *
+ * The link is sent with the switch tick of the region owning it.
+ * If cycle_control starts the consumer after the producer has finished its tick,
+ * the link is deferred until the consumer is started,
+ * thus data passes from producer to consumer within a single tick.
+ * \see thread::cycle_control::set_region_dependencies
+ */
+struct region_link
+{
+	region_link(const parallel_region* producer, const parallel_region* consumer)
+		: producer(producer), consumer(consumer)
+	{
+	}
+
+	const parallel_region* producer;
+	const parallel_region* consumer;
+	pure::event_source<void> switch_tick{};
+	/// set by cycle_control, if the link is sent when the consumer is started.
+	bool deferred = false;
+};
+
 /**
  * \brief class providing the interface to cyclic ticks for nodes.
  */
 class tick_controller
 {
 public:
-	tick_controller() = default;
+	tick_controller()
+	{
+		// reclaim_ticks_ is reclaimed by switch_buffers after it fired.
+		reclaim_ticks_.reclaim_tick();
+	}
 
 	/// sends void event on the switch tick of the surrounding region
 	pure::event_source<void>& switch_tick() { return switch_buffers_; }
+	/**
+	 * \brief sends void event after the switch tick of the surrounding region.
+	 * Unlike switch_tick, it may be connected from any thread while the region runs,
+	 * connect the reclaim_tick of concurrent ports to it.
+	 */
+	pure::concurrent_event_source<void>& reclaim_tick() { return reclaim_ticks_; }
 	/**
 	 * \brief  sends void event on the work tick of the surrounding region
 	 * connect nodes, that want to be triggered every cycle to this.
 	 */
 	pure::event_source<void>& work_tick() { return work; }
+	/**
+	 * \brief sends void event after the work tick, unless the region sheds optional work.
+	 * \see thread::overrun_action::shed_optional_work
+	 */
+	pure::event_source<void>& optional_work_tick() { return optional_work; }
 
 	/**
 	 * \brief Buffers in region will be switched when method is called.
 	 * expects event with no payload (void).
 	 */
-	void switch_buffers() { return switch_buffers_.fire(); }
+	void switch_buffers()
+	{
+		FC_TRACE_SPAN("switch_tick", "region");
+		++tick_generation;
+		switch_buffers_.fire();
+		for (auto& link : links_)
+			if (!link.deferred)
+				link.switch_tick.fire();
+		reclaim_ticks_.fire();
+		reclaim_ticks_.reclaim();
+	}
 	/**
 	 * \brief work ticks in region will be fired when event is received.
 	 * connect to scheduler.
 	 * expects event with no payload (void).
 	 */
-	auto in_work() { return [this](){ return work.fire(); };}
+	auto in_work()
+	{
+		return [this]()
+		{
+			FC_TRACE_SPAN("work_tick", "region");
+			work.fire();
+			if (!shed_optional)
+				optional_work.fire();
+		};
+	}
+
+	/**
+	 * \brief number of switch ticks of the region so far.
+	 * States computed in the region can be cached as long as it does not change.
+	 * Only switch_buffers changes it, the tasks of the region may read it concurrently.
+	 * \see pure::memoizing_state_source
+	 */
+	const std::atomic<uint64_t>& generation() const { return tick_generation; }
+
+	/**
+	 * \brief returns the link of buffers from producer to consumer owned by this region.
+	 * The link is created on first use.
+	 */
+	region_link& link(const parallel_region& producer, const parallel_region& consumer)
+	{
+		const auto existing = std::find_if(links_.begin(), links_.end(),
+				[&](const region_link& l)
+				{
+					return l.producer == &producer && l.consumer == &consumer;
+				});
+		if (existing != links_.end())
+			return *existing;
+		links_.emplace_back(&producer, &consumer);
+		return links_.back();
+	}
+	/// links owned by this region, \see link
+	std::list<region_link>& links() { return links_; }
 
 	pure::event_source<void> switch_buffers_;
 	pure::event_source<void> work;
+	pure::event_source<void> optional_work;
+	pure::concurrent_event_source<void> reclaim_ticks_;
+	/// set by the scheduler before the work tick, if the optional work is to be skipped.
+	bool shed_optional = false;
+	std::atomic<uint64_t> tick_generation{0};
+	std::list<region_link> links_;
 };
 
 /**
@@ -66,6 +168,7 @@ public:
 class parallel_region
 {
 public:
+	/// default length of a single tick, \see thread::cycle_control::set_min_tick_length
 	static constexpr wall_clock::steady::duration min_tick_length =
 			wall_clock::steady::duration(std::chrono::milliseconds(10));
 
@@ -73,8 +176,14 @@ public:
 	static constexpr virtual_clock::steady::duration medium_tick = min_tick_length * 10;
 	static constexpr virtual_clock::steady::duration slow_tick = min_tick_length * 100;
 
+	/**
+	 * \param id unique name of the region
+	 * \param duration tick rate of the region
+	 * \param phase offset of the ticks relative to multiples of the tick rate
+	 */
 	explicit parallel_region(std::string id,
-			virtual_clock::steady::duration duration);
+			virtual_clock::steady::duration duration,
+			virtual_clock::steady::duration phase = virtual_clock::steady::duration::zero());
 
 	parallel_region(const parallel_region&) = delete;
 	parallel_region(parallel_region&&) = default;
@@ -82,8 +191,63 @@ public:
 
 	region_id get_id() const;
 	virtual_clock::steady::duration get_duration() const;
+	virtual_clock::steady::duration get_phase() const;
 	pure::event_source<void>& switch_tick();
+	/// \see tick_controller::reclaim_tick
+	pure::concurrent_event_source<void>& reclaim_tick();
 	pure::event_source<void>& work_tick();
+	pure::event_source<void>& optional_work_tick();
+	/// cpus the tasks of the region are run on, empty if they may run anywhere.
+	const thread::cpu_set& get_affinity() const { return affinity; }
+	/**
+	 * \brief pins the tasks of the region to cpus.
+	 * Requires a scheduler supporting affinity like work_stealing_scheduler,
+	 * cycle_control refuses to start pinned regions with other schedulers.
+	 * Only the execution is pinned, build the nodes of the region with build_local
+	 * to place their memory on the numa node of these cpus.
+	 * \pre scheduler is not running
+	 */
+	void set_affinity(thread::cpu_set cpus) { affinity = std::move(cpus); }
+	/**
+	 * \brief runs build on a thread pinned to the cpus of the region and waits for it.
+	 * Nodes, ports and buffers constructed by build are placed on the numa node of these cpus,
+	 * \see thread::run_pinned. Runs build on the calling thread if the region is not pinned.
+	 */
+	void build_local(const std::function<void()>& build) const
+	{
+		thread::run_pinned(affinity, build);
+	}
+	/// number of events reserved in buffers of connections to or from the region.
+	size_t get_buffer_capacity() const { return buffer_capacity; }
+	/**
+	 * \brief reserves storage for capacity events in buffers of connections made afterwards,
+	 * thus buffers do not allocate as long as less events are sent per tick.
+	 */
+	void set_buffer_capacity(size_t capacity) { buffer_capacity = capacity; }
+	/// reaction of the scheduler to ticks of the region which are not finished in time.
+	const thread::overrun_policy& get_overrun_policy() const { return overrun; }
+	/// \pre scheduler is not running
+	void set_overrun_policy(const thread::overrun_policy& policy) { overrun = policy; }
+	/// true if the tasks of the region are passed to the scheduler with their deadline.
+	bool get_deadline_scheduling() const { return deadline_scheduling; }
+	/**
+	 * \brief passes the tasks of the region to the scheduler with their deadline.
+	 * parallel_scheduler lets such tasks overtake queued tasks with later deadlines
+	 * and runs them in yield, but keeps them in a heap protected by a mutex
+	 * instead of its lock free queue.
+	 * cycle_control dispatches the tasks of a tick in the order of their deadlines anyway,
+	 * thus only regions, which need to overtake tasks of earlier ticks or run in yield,
+	 * should enable this.
+	 * \pre scheduler is not running
+	 */
+	void set_deadline_scheduling(bool enabled) { deadline_scheduling = enabled; }
+	/// clock of the scheduler running the region, the process wide clock if there is none.
+	const virtual_clock::instance& get_clock() const
+	{
+		return clock ? *clock : virtual_clock::global();
+	}
+	/// set by the scheduler the region is added to. \pre scheduler is not running
+	void set_clock(std::shared_ptr<const virtual_clock::instance> c) { clock = std::move(c); }
 	/// Create new region from existing one.
 	virtual std::shared_ptr<parallel_region> new_region(std::string name,
 	                                                    virtual_clock::steady::duration) const;
@@ -91,6 +255,12 @@ public:
 	tick_controller ticks;
 	region_id id;
 	const virtual_clock::steady::duration tick_duration;
+	const virtual_clock::steady::duration tick_phase;
+	thread::cpu_set affinity;
+	size_t buffer_capacity = 0;
+	thread::overrun_policy overrun;
+	bool deadline_scheduling = false;
+	std::shared_ptr<const virtual_clock::instance> clock;
 };
 
 } /* namespace fc */
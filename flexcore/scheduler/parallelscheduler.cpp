@@ -1,5 +1,8 @@
 #include <flexcore/scheduler/parallelscheduler.hpp>
+#include <flexcore/scheduler/realtime.hpp>
+#include <flexcore/utils/tracing/tracing.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
@@ -7,6 +10,16 @@ namespace fc
 {
 namespace thread
 {
+constexpr size_t parallel_scheduler::default_queue_capacity;
+
+namespace
+{
+/// scheduler and deadline of the task running on the current thread.
+thread_local parallel_scheduler* current_scheduler = nullptr;
+thread_local wall_clock::steady::time_point current_deadline =
+		wall_clock::steady::time_point::max();
+}
+
 int parallel_scheduler::num_threads()
 {
 	const int nr = static_cast<int>(
@@ -15,10 +28,11 @@ int parallel_scheduler::num_threads()
 	return nr;
 }
 
-parallel_scheduler::parallel_scheduler() :
+parallel_scheduler::parallel_scheduler(size_t queue_capacity) :
 		thread_pool(),
 		do_work(false),
-		task_queue()
+		task_queue(queue_capacity),
+		overflow_queue()
 {
 	start();
 }
@@ -37,42 +51,122 @@ void parallel_scheduler::start() noexcept
 				//looks for tasks in task_queue and executes them
 				[this] ()
 				{
-					while (true)
+					FC_TRACE_REGISTER_THREAD();
+					task_t task;
+					auto deadline = wall_clock::steady::time_point::max();
+					size_t deadline_run = 0;
+					while (do_work.load())
 					{
-						task_t task;
+						if (deadline_run >= max_deadline_run && take_task(task))
+						{
+							deadline_run = 0;
+							run(task, wall_clock::steady::time_point::max());
+							continue;
+						}
+						if (take_deadline_task(task, deadline,
+								wall_clock::steady::time_point::max()))
 						{
-							queue_lock lock(task_queue_mutex);
-							// Wait while task_queue is empty and do_work is true.
-							// If do_work is false then exit loop. If task_queue is not empty, exit.
-							// Still need to check which condition is true after the while loop.
-							while (task_queue.empty() && do_work)
-								thread_control.wait(lock);
-
-							if (!do_work)
-								return;
-
-							// if we're here, then do_work must be true, and
-							// task_queue.empty() must be false.
-							assert(do_work);
-							assert(!task_queue.empty());
-
-							task = task_queue.front();
-							task_queue.pop();
+							++deadline_run;
+							run(task, deadline);
+							continue;
 						}
-						if (task)
-							task();
+						deadline_run = 0;
+						if (take_task(task))
+						{
+							run(task, wall_clock::steady::time_point::max());
+							continue;
+						}
+
+						queue_lock lock(sleep_mutex);
+						sleeping_workers.fetch_add(1);
+						// Wait while there are no tasks and do_work is true.
+						// Tasks are counted before they are added to the queue,
+						// thus a worker might wake up before the task is visible.
+						// It will then simply look again.
+						thread_control.wait(lock, [this]()
+						{
+							return waiting_tasks.load() != 0 || !do_work.load();
+						});
+						sleeping_workers.fetch_sub(1);
 					}
 				}));
 	}
 	assert(!thread_pool.empty()); //check invariant
 }
 
+void parallel_scheduler::run(task_t& task, wall_clock::steady::time_point deadline)
+{
+	auto* const previous_scheduler = current_scheduler;
+	const auto previous_deadline = current_deadline;
+	current_scheduler = this;
+	current_deadline = deadline;
+	FC_TRACE_INSTANT("dequeue", "scheduler");
+	if (task)
+		task();
+	task = nullptr;
+	current_scheduler = previous_scheduler;
+	current_deadline = previous_deadline;
+}
+
+size_t parallel_scheduler::yield()
+{
+	if (!current_scheduler)
+		return 0;
+	size_t nr_of_tasks = 0;
+	task_t task;
+	auto deadline = wall_clock::steady::time_point::max();
+	while (current_scheduler->take_deadline_task(task, deadline, current_deadline))
+	{
+		current_scheduler->run(task, deadline);
+		++nr_of_tasks;
+	}
+	return nr_of_tasks;
+}
+
+bool parallel_scheduler::take_deadline_task(task_t& task,
+		wall_clock::steady::time_point& deadline, wall_clock::steady::time_point limit)
+{
+	if (deadline_size.load() == 0)
+		return false;
+
+	queue_lock lock(deadline_mutex);
+	if (deadline_queue.empty() || !(deadline_queue.front().deadline < limit))
+		return false;
+	std::pop_heap(deadline_queue.begin(), deadline_queue.end(), later);
+	task = std::move(deadline_queue.back().task);
+	deadline = deadline_queue.back().deadline;
+	deadline_queue.pop_back();
+	deadline_size.fetch_sub(1);
+	waiting_tasks.fetch_sub(1);
+	return true;
+}
+
+bool parallel_scheduler::take_task(task_t& task)
+{
+	if (task_queue.try_pop(task))
+	{
+		waiting_tasks.fetch_sub(1);
+		return true;
+	}
+	if (overflow_size.load() == 0)
+		return false;
+
+	queue_lock lock(overflow_mutex);
+	if (overflow_queue.empty())
+		return false;
+	task = std::move(overflow_queue.front());
+	overflow_queue.pop();
+	overflow_size.fetch_sub(1);
+	waiting_tasks.fetch_sub(1);
+	return true;
+}
+
 void parallel_scheduler::stop() noexcept
 {
 	//first stop the infinite loop in all threads
 	{
-		//Acquire lock first, to stop work loops to enter while we set the flag.
-		queue_lock lock(task_queue_mutex);
+		//Acquire lock first, to stop work loops to go to sleep while we set the flag.
+		queue_lock lock(sleep_mutex);
 		do_work = false;
 	}
 	thread_control.notify_all();
@@ -87,6 +181,13 @@ void parallel_scheduler::stop() noexcept
 	assert(!thread_pool.empty()); //check invariant
 }
 
+void parallel_scheduler::set_worker_priority(int priority)
+{
+	for (auto& thread : thread_pool)
+		if (thread.joinable())
+			set_realtime_priority(thread, priority);
+}
+
 parallel_scheduler::~parallel_scheduler()
 {
 	//first stop all threads, destroying running threads is illegal
@@ -95,17 +196,53 @@ parallel_scheduler::~parallel_scheduler()
 
 size_t parallel_scheduler::nr_of_waiting_tasks() const
 {
-	queue_lock lock(task_queue_mutex);
-	return task_queue.size();
+	return waiting_tasks.load();
 }
 
 void parallel_scheduler::add_task(task_t new_task)
 {
+	// count the task before it is visible to the workers,
+	// so that nr_of_waiting_tasks never underflows.
+	waiting_tasks.fetch_add(1);
+	if (!task_queue.try_push(new_task))
+	{
+		queue_lock lock(overflow_mutex);
+		overflow_queue.push(std::move(new_task));
+		overflow_size.fetch_add(1);
+	}
+	wake_worker();
+}
+
+void parallel_scheduler::add_task(task_t new_task, const task_properties& properties)
+{
+	if (properties.deadline == wall_clock::steady::time_point::max())
+	{
+		add_task(std::move(new_task));
+		return;
+	}
+
+	waiting_tasks.fetch_add(1);
+	{
+		queue_lock lock(deadline_mutex);
+		deadline_queue.push_back(
+				deadline_task{properties.deadline, next_sequence++, std::move(new_task)});
+		std::push_heap(deadline_queue.begin(), deadline_queue.end(), later);
+		deadline_size.fetch_add(1);
+	}
+	wake_worker();
+}
+
+void parallel_scheduler::wake_worker()
+{
+	FC_TRACE_INSTANT("enqueue", "scheduler");
+	// only pay for the lock if somebody needs to be woken up.
+	if (sleeping_workers.load() != 0)
 	{
-		queue_lock lock(task_queue_mutex);
-		task_queue.push(std::move(new_task));
+		{
+			queue_lock lock(sleep_mutex);
+		}
+		thread_control.notify_one();
 	}
-	thread_control.notify_one();
 	assert(!thread_pool.empty()); //check invariant
 }
 
@@ -2,7 +2,10 @@
 #define SRC_SCHEDULER_PARALLELSCHEDULER_HPP_
 
 #include <flexcore/scheduler/scheduler.hpp>
+#include <flexcore/scheduler/detail/bounded_queue.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <thread>
 #include <vector>
 #include <queue>
@@ -18,6 +21,23 @@ namespace thread
  * \brief simple scheduler based on a threadpool
  *
  * Adds tasks a task queue. These tasks are then assigned to worker threads in a pool
+ * The task queue is a lock free ring buffer of fixed capacity.
+ * Only if the ring is full, tasks are stored in an overflow queue protected by a mutex.
+ * Tasks are executed in the order they were added, as long as the ring does not overflow.
+ *
+ * Tasks with a deadline in their task_properties, like the tasks of regions
+ * with deadline scheduling enabled, are kept in a separate queue ordered by deadline
+ * and run before tasks without deadline.
+ * Workers pick the task with the earliest deadline,
+ * thus regions with fast ticks are not delayed by slow regions which were added earlier.
+ * To not starve tasks without deadline, a worker takes a waiting task without deadline
+ * after every max_deadline_run tasks with deadline in a row.
+ * Long running tasks can call yield() to run tasks with earlier deadlines in between.
+ * The queue of deadline tasks is protected by a mutex,
+ * while any task with a deadline is waiting, workers lock it before using the lock free queue.
+ *
+ * All workers share the queues, thus the cpus in task_properties are not supported.
+ * Use work_stealing_scheduler for regions pinned to cpus.
  *
  * \invariant thread_pool.size() > 0
  */
@@ -25,29 +45,88 @@ class parallel_scheduler : public scheduler
 {
 public:
 	static int num_threads();
+	/// default capacity of the lock free task queue.
+	static constexpr size_t default_queue_capacity = 1024;
+	/// number of tasks with deadline a worker runs in a row, before it runs one without.
+	static constexpr size_t max_deadline_run = 4;
 
-	parallel_scheduler();
+	/// \pre queue_capacity is a power of two and > 1
+	explicit parallel_scheduler(size_t queue_capacity = default_queue_capacity);
 	parallel_scheduler(const parallel_scheduler&) = delete;
 	~parallel_scheduler() override;
 
 	///adds a new task and notifies waiting threads.
 	void add_task(task_t new_task) override;
+	/// adds a new task, which is run in the order of its deadline if it has one.
+	void add_task(task_t new_task, const task_properties& properties) override;
+
+	/**
+	 * \brief runs waiting tasks with an earlier deadline than the calling task on this thread.
+	 * Allows long running tasks to be cooperative, they call yield regularly,
+	 * to not delay tasks with shorter deadlines if all workers are busy.
+	 * Does nothing if not called from a task of a parallel_scheduler.
+	 * \return number of tasks run.
+	 */
+	static size_t yield();
 	/// stops the work loop of all threads
 	void stop() noexcept override;
+	/// sets SCHED_FIFO priority of all worker threads, throws std::system_error on failure.
+	void set_worker_priority(int priority) override;
 	size_t nr_of_waiting_tasks() const override;
 
 private:
 	/// startes the work loop of all threads
 	void start() noexcept;
+	/// takes the next task from the ring or the overflow queue, returns false if there is none.
+	bool take_task(task_t& task);
+	/**
+	 * \brief takes the task with the earliest deadline, if it is earlier than limit.
+	 * \return false if there is no such task.
+	 */
+	bool take_deadline_task(task_t& task, wall_clock::steady::time_point& deadline,
+			wall_clock::steady::time_point limit);
+	/// notifies a sleeping worker about a new task.
+	void wake_worker();
+	/// runs task with the given deadline as the current task of the calling thread.
+	void run(task_t& task, wall_clock::steady::time_point deadline);
+
+	struct deadline_task
+	{
+		wall_clock::steady::time_point deadline;
+		/// keeps the order of tasks with equal deadlines.
+		uint64_t sequence;
+		task_t task;
+	};
+	/// orders the heap of deadline tasks, such that the earliest deadline is at the front.
+	static bool later(const deadline_task& lhs, const deadline_task& rhs)
+	{
+		return lhs.deadline != rhs.deadline
+				? lhs.deadline > rhs.deadline
+				: lhs.sequence > rhs.sequence;
+	}
 
 	std::vector<std::thread> thread_pool;
-	bool do_work; ///< flag indicates threads to keep working.
+	std::atomic<bool> do_work; ///< flag indicates threads to keep working.
+
+	detail::bounded_mpmc_queue<task_t> task_queue;
+	/// number of tasks stored in task_queue and overflow_queue.
+	std::atomic<size_t> waiting_tasks{0};
+
+	/// stores tasks which did not fit into task_queue.
+	std::queue<task_t> overflow_queue;
+	std::atomic<size_t> overflow_size{0};
+	std::mutex overflow_mutex;
+
+	/// heap of the tasks with deadline, \see later
+	std::vector<deadline_task> deadline_queue;
+	std::atomic<size_t> deadline_size{0};
+	uint64_t next_sequence = 0;
+	std::mutex deadline_mutex;
 
-	// current implementation is simple and based on locking the task_queue,
-	//might be worthwhile exchanging it for a lockfree one.
-	std::queue<task_t> task_queue;
-	mutable std::mutex task_queue_mutex;
 	using queue_lock = std::unique_lock<std::mutex>;
+	/// number of workers waiting for thread_control, new tasks only notify if this is not 0.
+	std::atomic<size_t> sleeping_workers{0};
+	std::mutex sleep_mutex;
 	///used to notify worker threads if new tasks are available
 	std::condition_variable thread_control;
 };
@@ -0,0 +1,80 @@
+#include <flexcore/scheduler/realtime.hpp>
+
+#include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+#include <system_error>
+
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace fc
+{
+namespace thread
+{
+
+namespace
+{
+void set_priority(pthread_t handle, int priority)
+{
+	assert(priority >= 0);
+	sched_param param{};
+	param.sched_priority = priority;
+	const int policy = priority == 0 ? SCHED_OTHER : SCHED_FIFO;
+	const int error = pthread_setschedparam(handle, policy, &param);
+	if (error != 0)
+		throw std::system_error{error, std::system_category(),
+				"unable to set real-time priority"};
+}
+
+size_t page_size()
+{
+	return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+} // namespace
+
+void set_realtime_priority(std::thread& t, int priority)
+{
+	assert(t.joinable());
+	set_priority(t.native_handle(), priority);
+}
+
+void set_current_thread_realtime_priority(int priority)
+{
+	set_priority(pthread_self(), priority);
+}
+
+void lock_memory()
+{
+	if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+		throw std::system_error{errno, std::system_category(), "unable to lock memory"};
+}
+
+void prefault_stack(size_t bytes)
+{
+	auto* stack = static_cast<volatile char*>(alloca(bytes));
+	const auto step = page_size();
+	for (size_t i = 0; i < bytes; i += step)
+		stack[i] = 0;
+}
+
+void prefault_heap(size_t bytes)
+{
+	mallopt(M_TRIM_THRESHOLD, -1);
+	mallopt(M_MMAP_MAX, 0);
+	auto* heap = static_cast<volatile char*>(std::malloc(bytes));
+	if (!heap)
+		throw std::bad_alloc{};
+	const auto step = page_size();
+	for (size_t i = 0; i < bytes; i += step)
+		heap[i] = 0;
+	std::free(const_cast<char*>(heap));
+}
+
+} // namespace thread
+} // namespace fc
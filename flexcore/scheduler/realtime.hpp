@@ -0,0 +1,61 @@
+#ifndef SRC_SCHEDULER_REALTIME_HPP_
+#define SRC_SCHEDULER_REALTIME_HPP_
+
+#include <cstddef>
+#include <thread>
+
+namespace fc
+{
+namespace thread
+{
+
+/**
+ * \brief sets the scheduling policy of thread t.
+ * \param priority SCHED_FIFO priority in [1, 99],
+ * 0 sets the default time sharing policy.
+ * Throws std::system_error if the operating system refused, e.g. due to missing privileges.
+ * \pre t.joinable()
+ */
+void set_realtime_priority(std::thread& t, int priority);
+
+/// sets the scheduling policy of the calling thread, \see set_realtime_priority
+void set_current_thread_realtime_priority(int priority);
+
+/**
+ * \brief locks all current and future pages of the process in ram.
+ * Throws std::system_error if the operating system refused.
+ */
+void lock_memory();
+
+/**
+ * \brief touches bytes of the stack of the calling thread,
+ * thus later function calls do not page fault.
+ */
+void prefault_stack(size_t bytes);
+
+/**
+ * \brief allocates and touches bytes of heap.
+ * Trimming of the heap and mmap allocations are disabled,
+ * thus the memory stays with malloc and serves later allocations without page faults.
+ */
+void prefault_heap(size_t bytes);
+
+/// real-time settings of cycle_control, default values keep the settings of the process.
+struct realtime_settings
+{
+	/// SCHED_FIFO priority of the main loop thread, 0 keeps the default policy.
+	int main_loop_priority = 0;
+	/// SCHED_FIFO priority of the worker threads of the scheduler, 0 keeps the default policy.
+	int worker_priority = 0;
+	/// locks all memory of the process in ram, \see lock_memory
+	bool lock_memory = false;
+	/// bytes of stack of the main loop thread touched before the loop starts.
+	size_t prefault_stack = 0;
+	/// bytes of heap touched before the loop starts, \see prefault_heap
+	size_t prefault_heap = 0;
+};
+
+} // namespace thread
+} // namespace fc
+
+#endif /* SRC_SCHEDULER_REALTIME_HPP_ */
@@ -0,0 +1,165 @@
+#include <flexcore/scheduler/replay.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace fc
+{
+
+namespace
+{
+constexpr char log_magic[8] = {'F', 'C', 'E', 'V', 'L', 'O', 'G', '1'};
+
+template<class T>
+void write_raw(std::ostream& out, const T& value)
+{
+	out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<class T>
+T read_raw(std::istream& in)
+{
+	T value{};
+	if (!in.read(reinterpret_cast<char*>(&value), sizeof(value)))
+		throw std::runtime_error{"event log is truncated"};
+	return value;
+}
+} // namespace
+
+event_log::event_log(event_log&& other)
+{
+	std::lock_guard<std::mutex> lock(other.mtx);
+	events = std::move(other.events);
+	payloads = std::move(other.payloads);
+	sorted = other.sorted;
+}
+
+event_log& event_log::operator=(event_log&& other)
+{
+	if (this == &other)
+		return *this;
+	std::lock(mtx, other.mtx);
+	std::lock_guard<std::mutex> lock(mtx, std::adopt_lock);
+	std::lock_guard<std::mutex> other_lock(other.mtx, std::adopt_lock);
+	events = std::move(other.events);
+	payloads = std::move(other.payloads);
+	sorted = other.sorted;
+	return *this;
+}
+
+void event_log::record(virtual_clock::steady::time_point time, channel_t channel,
+		const void* data, size_t size)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	// threads might record with time stamps taken before the last tick.
+	if (!events.empty() && time < events.back().time)
+		sorted = false;
+	events.push_back(entry{time, channel, payloads.size(), size});
+	const auto* bytes = static_cast<const char*>(data);
+	payloads.insert(payloads.end(), bytes, bytes + size);
+}
+
+size_t event_log::size() const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	return events.size();
+}
+
+const std::vector<event_log::entry>& event_log::entries()
+{
+	if (!sorted)
+	{
+		std::stable_sort(events.begin(), events.end(),
+				[](const entry& lhs, const entry& rhs){ return lhs.time < rhs.time; });
+		sorted = true;
+	}
+	return events;
+}
+
+void event_log::write(std::ostream& out) const
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	// check all sizes before writing, to not leave a partial log behind.
+	for (const auto& e : events)
+		if (e.size > std::numeric_limits<uint32_t>::max())
+			throw std::length_error{"payload of " + std::to_string(e.size)
+					+ " bytes exceeds the event log format"};
+	out.write(log_magic, sizeof(log_magic));
+	write_raw(out, static_cast<uint64_t>(events.size()));
+	for (const auto& e : events)
+	{
+		write_raw(out, static_cast<int64_t>(e.time.time_since_epoch().count()));
+		write_raw(out, e.channel);
+		write_raw(out, static_cast<uint32_t>(e.size));
+		out.write(payloads.data() + e.offset, static_cast<std::streamsize>(e.size));
+	}
+}
+
+event_log event_log::read(std::istream& in)
+{
+	char magic[sizeof(log_magic)] = {};
+	if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, log_magic, sizeof(magic)) != 0)
+		throw std::runtime_error{"data is no event log"};
+
+	event_log log;
+	const auto nr_of_events = read_raw<uint64_t>(in);
+	std::vector<char> payload;
+	for (uint64_t i = 0; i != nr_of_events; ++i)
+	{
+		const auto time = virtual_clock::steady::time_point{
+				virtual_clock::duration{read_raw<int64_t>(in)}};
+		const auto channel = read_raw<channel_t>(in);
+		payload.resize(read_raw<uint32_t>(in));
+		if (!in.read(payload.data(), static_cast<std::streamsize>(payload.size())))
+			throw std::runtime_error{"event log is truncated"};
+		log.record(time, channel, payload.data(), payload.size());
+	}
+	return log;
+}
+
+namespace thread
+{
+
+replay_main_loop::replay_main_loop(event_log recorded)
+	: log(std::move(recorded))
+{
+	done.store(log.size() == 0);
+}
+
+void replay_main_loop::add_channel(event_log::channel_t channel, injector inject)
+{
+	channels[channel] = std::move(inject);
+}
+
+void replay_main_loop::loop_body(const std::function<void(void)>& work)
+{
+	const auto& events = log.entries();
+	skip_idle_ticks(next_event == events.size()
+			? virtual_clock::steady::time_point::max()
+			: events[next_event].time);
+
+	// events are injected between ticks, while no task reads the graph.
+	wait_for_current_tasks();
+	const auto now = virtual_clock::steady::now();
+	for (; next_event != events.size() && events[next_event].time <= now; ++next_event)
+	{
+		const auto& e = events[next_event];
+		const auto channel = channels.find(e.channel);
+		if (channel != channels.end())
+			channel->second(log.payload(e), e.size);
+	}
+	if (next_event == events.size())
+		done.store(true);
+
+	work();
+}
+
+} // namespace thread
+} // namespace fc
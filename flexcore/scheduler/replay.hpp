@@ -0,0 +1,118 @@
+#ifndef SRC_SCHEDULER_REPLAY_HPP_
+#define SRC_SCHEDULER_REPLAY_HPP_
+
+#include <flexcore/scheduler/clock.hpp>
+#include <flexcore/scheduler/cyclecontrol.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace fc
+{
+
+/**
+ * \brief log of timestamped events which entered the graph from outside.
+ *
+ * Payloads are stored as raw bytes in a single buffer.
+ * Events can be recorded from several threads concurrently.
+ * \see recording_tap to record events and thread::replay_main_loop to replay them.
+ */
+class event_log
+{
+public:
+	/// identifies the source an event was recorded at.
+	using channel_t = uint32_t;
+
+	struct entry
+	{
+		virtual_clock::steady::time_point time;
+		channel_t channel;
+		size_t offset; ///< position of the payload in the payload buffer
+		size_t size; ///< size of the payload in bytes
+	};
+
+	event_log() = default;
+	event_log(event_log&& other);
+	event_log& operator=(event_log&& other);
+
+	/// appends an event with a payload of size bytes starting at data.
+	void record(virtual_clock::steady::time_point time, channel_t channel,
+			const void* data, size_t size);
+
+	/// returns the number of recorded events
+	size_t size() const;
+
+	/**
+	 * \brief returns all events sorted by time, events with equal time keep their order.
+	 * \pre no events are recorded concurrently
+	 */
+	const std::vector<entry>& entries();
+
+	/// returns the payload of an entry of this log.
+	const char* payload(const entry& e) const { return payloads.data() + e.offset; }
+
+	/**
+	 * \brief writes the log in a compact binary format.
+	 * Integers are stored in the byte order of the host.
+	 * Throws std::length_error if a payload is larger than 4 GiB - 1 bytes.
+	 */
+	void write(std::ostream& out) const;
+
+	/// reads a log written by write, throws std::runtime_error if the data is malformed.
+	static event_log read(std::istream& in);
+
+private:
+	mutable std::mutex mtx;
+	std::vector<entry> events;
+	std::vector<char> payloads;
+	bool sorted = true;
+};
+
+namespace thread
+{
+
+/**
+ * \brief Main Loop which replays an event_log as fast as possible.
+ *
+ * Before each tick, once the tasks of the previous tick are done,
+ * all events of the log which were recorded at the current virtual time
+ * are passed to the injector of their channel.
+ * Ticks in which neither tasks are due nor events were recorded are skipped.
+ * As the virtual clock of each cycle_control starts at zero,
+ * events are replayed at the same virtual times at which they were recorded.
+ */
+class replay_main_loop final : public main_loop
+{
+public:
+	/// function which fires a recorded payload into the graph.
+	using injector = std::function<void(const char* data, size_t size)>;
+
+	explicit replay_main_loop(event_log log);
+
+	/// registers the injector for events of channel, events without injector are dropped.
+	void add_channel(event_log::channel_t channel, injector inject);
+
+	void loop_body(const std::function<void(void)>& work) override;
+
+	void arm() override {}
+
+	/// returns true if all events of the log have been injected.
+	bool finished() const { return done.load(); }
+
+private:
+	event_log log;
+	std::unordered_map<event_log::channel_t, injector> channels;
+	/// index of the next entry to inject
+	size_t next_event = 0;
+	std::atomic<bool> done{false};
+};
+
+} // namespace thread
+} // namespace fc
+
+#endif /* SRC_SCHEDULER_REPLAY_HPP_ */
@@ -1,17 +1,47 @@
 #ifndef SRC_THREADING_SCHEDULER_HPP_
 #define SRC_THREADING_SCHEDULER_HPP_
 
-#include <functional>
+#include <flexcore/core/detail/inline_function.hpp>
+#include <flexcore/scheduler/clock.hpp>
+
+#include <cstddef>
+#include <utility>
 
 namespace fc
 {
 namespace thread
 {
+class cpu_set;
+
+/// hints for schedulers how a task should be executed.
+struct task_properties
+{
+	/// cpus the task should run on, nullptr or empty if it can run anywhere.
+	const cpu_set* cpus = nullptr;
+	/// time the task should be finished, tasks without deadline use time_point::max().
+	wall_clock::steady::time_point deadline = wall_clock::steady::time_point::max();
+};
+
 class scheduler
 {
 public:
-	using task_t = std::function<void(void)>;
+	/// size of the inline storage of tasks, fits the captures used by cycle_control.
+	static constexpr size_t task_capacity = 2 * sizeof(void*);
+	/// move only task, tasks with captures up to task_capacity do not allocate.
+	using task_t = fc::detail::inline_function<void(void), task_capacity>;
 	virtual void add_task(task_t new_task) = 0;
+	/// adds a task with hints, schedulers which do not support the hints ignore them.
+	virtual void add_task(task_t new_task, const task_properties& /*properties*/)
+	{
+		add_task(std::move(new_task));
+	}
+	/**
+	 * \brief sets the scheduling policy of all worker threads, \see set_realtime_priority
+	 * Schedulers without own threads ignore it.
+	 */
+	virtual void set_worker_priority(int /*priority*/) {}
+	/// returns true if the scheduler runs tasks only on the cpus in their task_properties.
+	virtual bool supports_affinity() const { return false; }
 	virtual void stop() = 0;
 	virtual size_t nr_of_waiting_tasks() const = 0;
 	virtual ~scheduler() = default;
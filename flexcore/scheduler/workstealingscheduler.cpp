@@ -0,0 +1,265 @@
+#include <flexcore/scheduler/workstealingscheduler.hpp>
+#include <flexcore/scheduler/realtime.hpp>
+#include <flexcore/utils/tracing/tracing.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace fc
+{
+namespace thread
+{
+
+namespace
+{
+// identifies the scheduler and worker the current thread belongs to,
+// tasks added by a worker are kept in its own queue.
+thread_local const work_stealing_scheduler* current_scheduler = nullptr;
+thread_local size_t current_worker = 0;
+
+/// xorshift generator, used to pick the victim of a steal.
+size_t next_random(size_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+}
+
+int work_stealing_scheduler::default_nr_of_threads()
+{
+	return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+work_stealing_scheduler::work_stealing_scheduler(int nr_of_threads)
+	: work_stealing_scheduler(std::vector<cpu_set>(std::max(nr_of_threads, 0)))
+{
+	assert(nr_of_threads > 0);
+}
+
+work_stealing_scheduler::work_stealing_scheduler(std::vector<cpu_set> cpus)
+	: worker_cpus(std::move(cpus))
+{
+	assert(!worker_cpus.empty());
+	for (size_t i = 0; i != worker_cpus.size(); ++i)
+		queues.push_back(std::make_unique<worker_queue>());
+
+	//start threads only after all queues exist, since workers access all of them.
+	for (size_t i = 0; i != queues.size(); ++i)
+		thread_pool.emplace_back([this, i]() { work(i); });
+
+	assert(!thread_pool.empty()); //check invariant
+	assert(thread_pool.size() == queues.size());
+}
+
+void work_stealing_scheduler::set_worker_priority(int priority)
+{
+	for (auto& thread : thread_pool)
+		if (thread.joinable())
+			set_realtime_priority(thread, priority);
+}
+
+work_stealing_scheduler::~work_stealing_scheduler()
+{
+	//first stop all threads, destroying running threads is illegal
+	stop();
+}
+
+void work_stealing_scheduler::add_task(task_t new_task)
+{
+	const size_t target = current_scheduler == this
+			? current_worker
+			: next_queue.fetch_add(1) % queues.size();
+	push_task(target, queued_task{std::move(new_task), nullptr});
+}
+
+void work_stealing_scheduler::add_task(task_t new_task, const task_properties& properties)
+{
+	const cpu_set* cpus = properties.cpus;
+	if (!cpus || cpus->empty())
+	{
+		add_task(std::move(new_task));
+		return;
+	}
+	if (current_scheduler == this && runs_on(current_worker, cpus))
+	{
+		push_task(current_worker, queued_task{std::move(new_task), cpus});
+		return;
+	}
+
+	const size_t nr_of_queues = queues.size();
+	const size_t first = next_queue.fetch_add(1) % nr_of_queues;
+	for (size_t i = 0; i != nr_of_queues; ++i)
+	{
+		const size_t target = (first + i) % nr_of_queues;
+		if (runs_on(target, cpus))
+		{
+			push_task(target, queued_task{std::move(new_task), cpus});
+			return;
+		}
+	}
+	// no worker is pinned to the cpus of the task, thus any worker may run it.
+	push_task(first, queued_task{std::move(new_task), nullptr});
+}
+
+bool work_stealing_scheduler::runs_on(size_t worker, const cpu_set* cpus) const
+{
+	if (!cpus)
+		return true;
+	const auto& own_cpus = worker_cpus[worker];
+	return !own_cpus.empty() && own_cpus.is_subset_of(*cpus);
+}
+
+void work_stealing_scheduler::count_task(const cpu_set* cpus, int delta)
+{
+	if (!cpus)
+	{
+		unpinned_tasks.fetch_add(delta);
+		return;
+	}
+	for (size_t worker = 0; worker != queues.size(); ++worker)
+		if (runs_on(worker, cpus))
+			queues[worker]->pinned_tasks.fetch_add(delta);
+}
+
+void work_stealing_scheduler::push_task(size_t target, queued_task task)
+{
+	// count the task before it is visible to the workers,
+	// so that nr_of_waiting_tasks never underflows.
+	waiting_tasks.fetch_add(1);
+	count_task(task.cpus, 1);
+	FC_TRACE_INSTANT("enqueue", "scheduler");
+	const bool pinned = task.cpus != nullptr;
+	{
+		auto& queue = *queues[target];
+		queue_lock lock(queue.mtx);
+		queue.tasks.push_back(std::move(task));
+	}
+
+	// only pay for the lock if somebody needs to be woken up.
+	if (sleeping_workers.load() != 0)
+	{
+		{
+			queue_lock lock(sleep_mutex);
+		}
+		// a single woken worker might not be allowed to run a pinned task.
+		if (pinned)
+			thread_control.notify_all();
+		else
+			thread_control.notify_one();
+	}
+}
+
+void work_stealing_scheduler::stop() noexcept
+{
+	{
+		//Acquire lock first, to stop workers from going to sleep while we set the flag.
+		queue_lock lock(sleep_mutex);
+		do_work.store(false);
+	}
+	thread_control.notify_all();
+	for (auto& thread : thread_pool)
+	{
+		if (thread.joinable())
+			thread.join();
+	}
+	assert(!thread_pool.empty()); //check invariant
+}
+
+size_t work_stealing_scheduler::nr_of_waiting_tasks() const
+{
+	return waiting_tasks.load();
+}
+
+void work_stealing_scheduler::work(size_t self)
+{
+	// failing to pin a worker is not fatal, it then simply runs anywhere.
+	if (!worker_cpus[self].empty())
+		pin_current_thread(worker_cpus[self]);
+	FC_TRACE_REGISTER_THREAD();
+	current_scheduler = this;
+	current_worker = self;
+	// every worker needs a different, non zero seed.
+	size_t random_state = self + 1;
+
+	task_t task;
+	while (do_work.load())
+	{
+		if (find_task(self, random_state, task))
+		{
+			FC_TRACE_INSTANT("dequeue", "scheduler");
+			if (task)
+				task();
+			task = nullptr;
+		}
+		else
+		{
+			wait_for_tasks(self);
+		}
+	}
+}
+
+bool work_stealing_scheduler::find_task(size_t self, size_t& random_state, task_t& task)
+{
+	auto take = [this, self, &task](worker_queue& queue, bool own)
+	{
+		queue_lock lock(queue.mtx);
+		if (queue.tasks.empty())
+			return false;
+		const cpu_set* cpus = nullptr;
+		if (own)
+		{
+			task = std::move(queue.tasks.back().task);
+			cpus = queue.tasks.back().cpus;
+			queue.tasks.pop_back();
+		}
+		else
+		{
+			// thieves skip tasks which are pinned to other cpus.
+			const auto stolen = std::find_if(queue.tasks.begin(), queue.tasks.end(),
+					[this, self](const queued_task& t){ return runs_on(self, t.cpus); });
+			if (stolen == queue.tasks.end())
+				return false;
+			task = std::move(stolen->task);
+			cpus = stolen->cpus;
+			queue.tasks.erase(stolen);
+		}
+		count_task(cpus, -1);
+		waiting_tasks.fetch_sub(1);
+		return true;
+	};
+
+	if (take(*queues[self], true))
+		return true;
+
+	const size_t nr_of_queues = queues.size();
+	const size_t first_victim = next_random(random_state) % nr_of_queues;
+	for (size_t i = 0; i != nr_of_queues; ++i)
+	{
+		const size_t victim = (first_victim + i) % nr_of_queues;
+		if (victim != self && take(*queues[victim], false))
+			return true;
+	}
+	return false;
+}
+
+void work_stealing_scheduler::wait_for_tasks(size_t self)
+{
+	queue_lock lock(sleep_mutex);
+	sleeping_workers.fetch_add(1);
+	// Tasks are counted before they are pushed, thus a worker might wake up
+	// and not find the task yet. It will then simply look again.
+	// Tasks pinned to cpus of other workers do not keep this worker awake.
+	thread_control.wait(lock, [this, self]()
+	{
+		return unpinned_tasks.load() != 0
+				|| queues[self]->pinned_tasks.load() != 0
+				|| !do_work.load();
+	});
+	sleeping_workers.fetch_sub(1);
+}
+
+} /* namespace thread */
+} /* namespace fc */
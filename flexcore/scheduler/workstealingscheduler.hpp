@@ -0,0 +1,119 @@
+#ifndef SRC_SCHEDULER_WORKSTEALINGSCHEDULER_HPP_
+#define SRC_SCHEDULER_WORKSTEALINGSCHEDULER_HPP_
+
+#include <flexcore/scheduler/affinity.hpp>
+#include <flexcore/scheduler/scheduler.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fc
+{
+namespace thread
+{
+
+/**
+ * \brief scheduler based on a threadpool with one task queue per worker.
+ *
+ * Tasks added from outside of the pool are distributed round robin over the queues
+ * of all workers. Tasks added from within a worker are put in the queue of that worker.
+ * Workers take tasks from the back of their own queue and, if it is empty,
+ * steal from the front of the queue of a randomly chosen other worker.
+ * Thus workers only contend for a lock if they access the same queue.
+ *
+ * Workers can be pinned to cpus. Tasks with a cpu set in their task_properties
+ * are then only executed and stolen by workers pinned to a subset of these cpus.
+ * If no such worker exists, the cpu set of the task is ignored.
+ *
+ * \invariant thread_pool.size() == queues.size()
+ * \invariant thread_pool.size() > 0
+ */
+class work_stealing_scheduler : public scheduler
+{
+public:
+	/**
+	 * \brief starts a pool of nr_of_threads worker threads
+	 * \pre nr_of_threads > 0
+	 */
+	explicit work_stealing_scheduler(int nr_of_threads = default_nr_of_threads());
+	/**
+	 * \brief starts one worker for every element of worker_cpus, pinned to these cpus.
+	 * Workers with an empty cpu set are not pinned.
+	 * \pre !worker_cpus.empty()
+	 * \see cpu_set::single_cpus to start a pinned worker on every cpu.
+	 */
+	explicit work_stealing_scheduler(std::vector<cpu_set> worker_cpus);
+	work_stealing_scheduler(const work_stealing_scheduler&) = delete;
+	~work_stealing_scheduler() override;
+
+	/// number of threads used if none are given in the constructor, one per hardware thread.
+	static int default_nr_of_threads();
+
+	/// adds a new task to the queue of the next worker and wakes a sleeping worker.
+	void add_task(task_t new_task) override;
+	/// adds a new task to the queue of a worker which is pinned to the cpus of the task.
+	void add_task(task_t new_task, const task_properties& properties) override;
+	/// stops the work loop of all threads, tasks which are still queued are not executed.
+	void stop() noexcept override;
+	/// sets SCHED_FIFO priority of all worker threads, throws std::system_error on failure.
+	void set_worker_priority(int priority) override;
+	bool supports_affinity() const override { return true; }
+	size_t nr_of_waiting_tasks() const override;
+
+	/// returns the number of worker threads in the pool.
+	size_t nr_of_threads() const { return thread_pool.size(); }
+
+private:
+	struct queued_task
+	{
+		task_t task;
+		/// cpus the task is restricted to, nullptr if it can run anywhere.
+		const cpu_set* cpus;
+	};
+
+	/// task queue of a single worker, owner works at the back, thieves at the front.
+	struct worker_queue
+	{
+		std::mutex mtx;
+		std::deque<queued_task> tasks;
+		/// number of pinned tasks in all queues, which this worker may run.
+		std::atomic<size_t> pinned_tasks{0};
+	};
+	using queue_lock = std::unique_lock<std::mutex>;
+
+	/// work loop of worker with index self
+	void work(size_t self);
+	/// takes a task from back of own queue or steals one from the front of another queue.
+	bool find_task(size_t self, size_t& random_state, task_t& task);
+	/// waits until a task worker self may run is available or the scheduler is stopped.
+	void wait_for_tasks(size_t self);
+	/// adds delta to the counters of all workers allowed to run a task pinned to cpus.
+	void count_task(const cpu_set* cpus, int delta);
+	/// pushes task to the queue of worker target and wakes up sleeping workers.
+	void push_task(size_t target, queued_task task);
+	/// returns true if worker is allowed to execute a task restricted to cpus.
+	bool runs_on(size_t worker, const cpu_set* cpus) const;
+
+	std::vector<cpu_set> worker_cpus;
+	std::vector<std::unique_ptr<worker_queue>> queues;
+	std::vector<std::thread> thread_pool;
+	std::atomic<bool> do_work{true}; ///< flag indicates threads to keep working.
+	std::atomic<size_t> waiting_tasks{0}; ///< number of tasks stored in all queues.
+	/// number of tasks in all queues, which every worker may run.
+	std::atomic<size_t> unpinned_tasks{0};
+	std::atomic<size_t> next_queue{0}; ///< queue for the next task added from outside
+	std::atomic<size_t> sleeping_workers{0};
+	///used to notify sleeping worker threads if new tasks are available
+	std::mutex sleep_mutex;
+	std::condition_variable thread_control;
+};
+
+} /* namespace thread */
+} /* namespace fc */
+
+#endif /* SRC_SCHEDULER_WORKSTEALINGSCHEDULER_HPP_ */
@@ -0,0 +1,341 @@
+#include <flexcore/utils/tracing/tracing.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <new>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace fc
+{
+namespace trace
+{
+
+constexpr size_t recorder::default_capacity;
+
+namespace
+{
+enum class phase : uint8_t
+{
+	complete,
+	instant
+};
+
+std::atomic<uint64_t> next_generation{1};
+
+/// recorders which are alive by their generation, exiting threads release their rings there.
+struct live_recorders
+{
+	std::mutex mtx;
+	std::unordered_map<uint64_t, recorder*> recorders;
+};
+live_recorders& alive()
+{
+	// never destroyed, since threads might exit after static destruction.
+	static auto* const instance = new live_recorders();
+	return *instance;
+}
+
+void write_escaped(std::ostream& out, const char* text)
+{
+	out << '"';
+	for (; *text != '\0'; ++text)
+	{
+		const char c = *text;
+		if (c == '"' || c == '\\')
+			out << '\\' << c;
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			char escaped[8];
+			std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+			out << escaped;
+		}
+		else
+			out << c;
+	}
+	out << '"';
+}
+
+/// writes nanoseconds as microseconds, the unit of the Chrome trace format.
+void write_microseconds(std::ostream& out, uint64_t nanoseconds)
+{
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%llu.%03llu",
+			static_cast<unsigned long long>(nanoseconds / 1000),
+			static_cast<unsigned long long>(nanoseconds % 1000));
+	out << buffer;
+}
+} // namespace
+
+/**
+ * \brief ring of records written by a single thread.
+ *
+ * Slots are protected by a sequence number, which is zero while the slot is written,
+ * thus readers can detect and skip records which are overwritten while they are read.
+ */
+struct recorder::thread_ring
+{
+	struct slot
+	{
+		std::atomic<const char*> name{nullptr};
+		std::atomic<const char*> category{nullptr};
+		std::atomic<uint64_t> begin{0};
+		std::atomic<uint64_t> end{0};
+		std::atomic<phase> kind{phase::complete};
+		/// position of the record in the ring plus one, zero while it is written.
+		std::atomic<uint64_t> sequence{0};
+	};
+
+	thread_ring(size_t capacity, size_t thread_id)
+		: slots(new slot[capacity])
+		, capacity(capacity)
+		, thread_id(thread_id)
+	{
+	}
+
+	void write(const char* name, const char* category, uint64_t begin, uint64_t end,
+			phase kind) noexcept
+	{
+		const auto position = head.load(std::memory_order_relaxed);
+		auto& s = slots[position % capacity];
+		s.sequence.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		s.name.store(name, std::memory_order_relaxed);
+		s.category.store(category, std::memory_order_relaxed);
+		s.begin.store(begin, std::memory_order_relaxed);
+		s.end.store(end, std::memory_order_relaxed);
+		s.kind.store(kind, std::memory_order_relaxed);
+		s.sequence.store(position + 1, std::memory_order_release);
+		head.store(position + 1, std::memory_order_release);
+	}
+
+	/// calls f with all records which are completely written.
+	template<class function>
+	void for_each(function f) const
+	{
+		const auto end = head.load(std::memory_order_acquire);
+		const auto first = end > capacity ? end - capacity : 0;
+		for (auto position = first; position != end; ++position)
+		{
+			const auto& s = slots[position % capacity];
+			if (s.sequence.load(std::memory_order_acquire) != position + 1)
+				continue;
+			const auto name = s.name.load(std::memory_order_relaxed);
+			const auto category = s.category.load(std::memory_order_relaxed);
+			const auto begin = s.begin.load(std::memory_order_relaxed);
+			const auto finish = s.end.load(std::memory_order_relaxed);
+			const auto kind = s.kind.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (s.sequence.load(std::memory_order_relaxed) != position + 1)
+				continue;
+			f(name, category, begin, finish, kind);
+		}
+	}
+
+	size_t size() const
+	{
+		return std::min<uint64_t>(head.load(std::memory_order_acquire), capacity);
+	}
+
+	void clear()
+	{
+		for (size_t i = 0; i != capacity; ++i)
+			slots[i].sequence.store(0, std::memory_order_relaxed);
+		head.store(0, std::memory_order_release);
+	}
+
+	std::unique_ptr<slot[]> slots;
+	const size_t capacity;
+	const size_t thread_id;
+	std::atomic<uint64_t> head{0};
+	/// set when the writing thread exited, the ring is then released by clear.
+	bool exited = false;
+};
+
+struct recorder::local_rings
+{
+	~local_rings()
+	{
+		auto& live = alive();
+		std::lock_guard<std::mutex> lock(live.mtx);
+		for (const auto& entry : entries)
+		{
+			const auto owner = live.recorders.find(entry.first);
+			if (owner != live.recorders.end())
+				owner->second->release(entry.second);
+		}
+	}
+
+	/// rings of the calling thread, identified by the generation of their recorder.
+	std::vector<std::pair<uint64_t, thread_ring*>> entries;
+};
+
+thread_local recorder::local_rings recorder::local;
+
+recorder& recorder::instance()
+{
+	// never destroyed, thus threads can record until the process exits.
+	static recorder* const global = new recorder();
+	return *global;
+}
+
+recorder::recorder(size_t capacity_per_thread)
+	: capacity(std::max<size_t>(capacity_per_thread, 1))
+	, generation(next_generation.fetch_add(1))
+{
+	auto& live = alive();
+	std::lock_guard<std::mutex> lock(live.mtx);
+	live.recorders.emplace(generation, this);
+}
+
+recorder::~recorder()
+{
+	auto& live = alive();
+	std::lock_guard<std::mutex> lock(live.mtx);
+	live.recorders.erase(generation);
+}
+
+uint64_t recorder::now() noexcept
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+recorder::thread_ring* recorder::local_ring() const noexcept
+{
+	for (const auto& entry : local.entries)
+		if (entry.first == generation)
+			return entry.second;
+	return nullptr;
+}
+
+bool recorder::register_thread() noexcept
+{
+	if (local_ring())
+		return true;
+
+	try
+	{
+		// reserve first, thus the ring is not leaked if the lists cannot grow.
+		local.entries.reserve(local.entries.size() + 1);
+		std::lock_guard<std::mutex> lock(rings_mutex);
+		rings.reserve(rings.size() + 1);
+		rings.push_back(std::make_unique<thread_ring>(capacity, next_thread_id++));
+		local.entries.emplace_back(generation, rings.back().get());
+		return true;
+	}
+	catch (const std::bad_alloc&)
+	{
+		return false;
+	}
+}
+
+void recorder::release(thread_ring* ring)
+{
+	std::lock_guard<std::mutex> lock(rings_mutex);
+	const auto owned = std::find_if(rings.begin(), rings.end(),
+			[ring](const auto& r){ return r.get() == ring; });
+	assert(owned != rings.end());
+	// keep the records of the thread until they are cleared.
+	if (ring->size() == 0)
+		rings.erase(owned);
+	else
+		ring->exited = true;
+}
+
+void recorder::record(const char* name, const char* category,
+		uint64_t begin, uint64_t end) noexcept
+{
+	if (!is_enabled())
+		return;
+	auto* const ring = local_ring();
+	if (!ring)
+	{
+		nr_of_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	ring->write(name, category, begin, end, phase::complete);
+}
+
+void recorder::record_instant(const char* name, const char* category) noexcept
+{
+	if (!is_enabled())
+		return;
+	auto* const ring = local_ring();
+	if (!ring)
+	{
+		nr_of_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	const auto time = now();
+	ring->write(name, category, time, time, phase::instant);
+}
+
+const char* recorder::intern(const std::string& name)
+{
+	static std::mutex names_mutex;
+	// never destroyed, since pointers to the names are stored in records.
+	static auto* const names = new std::unordered_set<std::string>();
+	std::lock_guard<std::mutex> lock(names_mutex);
+	return names->insert(name).first->c_str();
+}
+
+void recorder::write_chrome_json(std::ostream& out) const
+{
+	std::lock_guard<std::mutex> lock(rings_mutex);
+	out << "{\"traceEvents\":[";
+	bool first = true;
+	for (const auto& ring : rings)
+	{
+		ring->for_each([&](const char* name, const char* category,
+				uint64_t begin, uint64_t end, phase kind)
+		{
+			out << (first ? "\n" : ",\n") << "{\"name\":";
+			first = false;
+			write_escaped(out, name);
+			out << ",\"cat\":";
+			write_escaped(out, category);
+			if (kind == phase::instant)
+				out << ",\"ph\":\"i\",\"s\":\"t\"";
+			else
+			{
+				out << ",\"ph\":\"X\",\"dur\":";
+				write_microseconds(out, end - begin);
+			}
+			out << ",\"ts\":";
+			write_microseconds(out, begin);
+			out << ",\"pid\":1,\"tid\":" << ring->thread_id << '}';
+		});
+	}
+	out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+size_t recorder::size() const
+{
+	std::lock_guard<std::mutex> lock(rings_mutex);
+	size_t total = 0;
+	for (const auto& ring : rings)
+		total += ring->size();
+	return total;
+}
+
+size_t recorder::nr_of_rings() const
+{
+	std::lock_guard<std::mutex> lock(rings_mutex);
+	return rings.size();
+}
+
+void recorder::clear()
+{
+	std::lock_guard<std::mutex> lock(rings_mutex);
+	rings.erase(std::remove_if(rings.begin(), rings.end(),
+			[](const auto& ring){ return ring->exited; }), rings.end());
+	for (auto& ring : rings)
+		ring->clear();
+	nr_of_dropped.store(0, std::memory_order_relaxed);
+}
+
+} // namespace trace
+} // namespace fc
@@ -0,0 +1,166 @@
+#ifndef SRC_UTILS_TRACING_TRACING_HPP_
+#define SRC_UTILS_TRACING_TRACING_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fc
+{
+/**
+ * \brief recording of spans on a timeline of all threads.
+ *
+ * The library records the execution of periodic tasks, switch and work ticks,
+ * event_buffer::send_events and the scheduler queues,
+ * if it is built with the cmake option FLEXCORE_ENABLE_TRACING.
+ * Otherwise the trace macros expand to nothing.
+ */
+namespace trace
+{
+
+/**
+ * \brief stores spans in per thread lock free ring buffers and writes them as Chrome trace.
+ *
+ * Every thread writes to its own ring buffer, which is allocated by register_thread,
+ * thus recording neither locks nor allocates.
+ * Records of threads without ring are dropped and counted, \see dropped.
+ * The workers of the schedulers and the main loop of cycle_control register themselves.
+ * If a ring is full, the oldest records of the thread are overwritten.
+ * Rings of exited threads are kept until clear, thus their records can still be written.
+ * Names and categories are stored as pointers, thus need to outlive the recorder,
+ * use string literals or intern.
+ */
+class recorder
+{
+public:
+	/// default number of records stored per thread.
+	static constexpr size_t default_capacity = 1 << 14;
+
+	/// returns the process wide recorder used by the trace macros.
+	static recorder& instance();
+
+	explicit recorder(size_t capacity_per_thread = default_capacity);
+	recorder(const recorder&) = delete;
+	recorder& operator=(const recorder&) = delete;
+	~recorder();
+
+	/// returns the current time in the time base of the records.
+	static uint64_t now() noexcept;
+
+	/**
+	 * \brief allocates the ring of the calling thread, does nothing if it already has one.
+	 * The ring is released when the thread exits and its records have been cleared.
+	 * \returns false if the ring could not be allocated, records of the thread are dropped then.
+	 */
+	bool register_thread() noexcept;
+
+	/// records a span from begin to end in the ring of the calling thread.
+	void record(const char* name, const char* category, uint64_t begin, uint64_t end) noexcept;
+	/// records an event without duration in the ring of the calling thread.
+	void record_instant(const char* name, const char* category) noexcept;
+
+	/// pauses or resumes recording, recording is enabled initially.
+	void set_enabled(bool enable) noexcept { enabled.store(enable, std::memory_order_relaxed); }
+	bool is_enabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+	/**
+	 * \brief returns a copy of name, which lives as long as the process.
+	 * Equal names return the same pointer.
+	 */
+	static const char* intern(const std::string& name);
+
+	/**
+	 * \brief writes all records in the Chrome trace event format (JSON).
+	 * The result can be loaded in chrome://tracing or the Perfetto UI.
+	 * Can be called while threads are recording, records written meanwhile might be missing.
+	 */
+	void write_chrome_json(std::ostream& out) const;
+
+	/// returns the number of records currently stored for all threads.
+	size_t size() const;
+	/// returns the number of records dropped, since the recording thread had no ring.
+	size_t dropped() const noexcept { return nr_of_dropped.load(std::memory_order_relaxed); }
+	/// returns the number of rings, which are allocated for registered threads.
+	size_t nr_of_rings() const;
+
+	/**
+	 * \brief removes all records and releases the rings of exited threads.
+	 * \pre no concurrent calls to record
+	 */
+	void clear();
+
+private:
+	struct thread_ring;
+	/// rings of the calling thread, released when the thread exits.
+	struct local_rings;
+
+	/// returns the ring of the calling thread, nullptr if it is not registered.
+	thread_ring* local_ring() const noexcept;
+	/// called when the thread writing ring exits.
+	void release(thread_ring* ring);
+
+	static thread_local local_rings local;
+
+	const size_t capacity;
+	std::atomic<bool> enabled{true};
+	std::atomic<size_t> nr_of_dropped{0};
+	/// identifies the recorder in the thread local lists of rings.
+	const uint64_t generation;
+	mutable std::mutex rings_mutex;
+	std::vector<std::unique_ptr<thread_ring>> rings;
+	size_t next_thread_id = 0;
+};
+
+/// records the lifetime of a span in the recorder.
+class span
+{
+public:
+	span(const char* name, const char* category,
+			recorder& target = recorder::instance()) noexcept
+		: target(target)
+		, name(name)
+		, category(category)
+		, begin(recorder::now())
+	{
+	}
+	~span() { target.record(name, category, begin, recorder::now()); }
+
+	span(const span&) = delete;
+	span& operator=(const span&) = delete;
+
+private:
+	recorder& target;
+	const char* name;
+	const char* category;
+	const uint64_t begin;
+};
+
+} // namespace trace
+} // namespace fc
+
+#define FC_TRACE_CONCAT_IMPL(a, b) a##b
+#define FC_TRACE_CONCAT(a, b) FC_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef FLEXCORE_ENABLE_TRACING
+/// records a span from this point to the end of the enclosing scope.
+#define FC_TRACE_SPAN(name, category) \
+	const ::fc::trace::span FC_TRACE_CONCAT(fc_trace_span_, __LINE__){name, category}
+/// records an event without duration.
+#define FC_TRACE_INSTANT(name, category) \
+	::fc::trace::recorder::instance().record_instant(name, category)
+/// allocates the ring of the calling thread in the process wide recorder.
+#define FC_TRACE_REGISTER_THREAD() \
+	::fc::trace::recorder::instance().register_thread()
+#else
+#define FC_TRACE_SPAN(name, category) static_cast<void>(0)
+#define FC_TRACE_INSTANT(name, category) static_cast<void>(0)
+#define FC_TRACE_REGISTER_THREAD() static_cast<void>(0)
+#endif
+
+#endif /* SRC_UTILS_TRACING_TRACING_HPP_ */
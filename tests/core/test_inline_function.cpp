@@ -0,0 +1,92 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/core/detail/inline_function.hpp>
+
+#include <array>
+#include <memory>
+
+using fc::detail::inline_function;
+
+BOOST_AUTO_TEST_SUITE(test_inline_function)
+
+namespace
+{
+struct count_instances
+{
+	explicit count_instances(int& counter) : counter(&counter) { ++*this->counter; }
+	count_instances(count_instances&& o) noexcept : counter(o.counter) { ++*counter; }
+	~count_instances() { --*counter; }
+	int operator()(int in) const { return in + 1; }
+	int* counter;
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+	inline_function<void(), 16> f;
+	BOOST_CHECK(!f);
+	inline_function<void(), 16> g = nullptr;
+	BOOST_CHECK(!g);
+}
+
+BOOST_AUTO_TEST_CASE(test_call)
+{
+	int called = 0;
+	inline_function<int(int), 16> f{[&called](int in) { ++called; return in * 2; }};
+	BOOST_CHECK(f);
+	BOOST_CHECK_EQUAL(f(21), 42);
+	BOOST_CHECK_EQUAL(called, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_move_only_callable)
+{
+	auto ptr = std::make_unique<int>(5);
+	inline_function<int(), 16> f{[p = std::move(ptr)] { return *p; }};
+	static_assert(decltype(f)::stores_inline<std::unique_ptr<int>>(),
+			"a single pointer is expected to fit.");
+	auto g = std::move(f);
+	BOOST_CHECK(!f);
+	BOOST_CHECK(g);
+	BOOST_CHECK_EQUAL(g(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(test_large_callable)
+{
+	std::array<int, 64> big{};
+	big[63] = 7;
+	using function_t = inline_function<int(), 16>;
+	BOOST_CHECK((!function_t::stores_inline<std::array<int, 64>>()));
+	function_t f{[big] { return big[63]; }};
+	function_t g{std::move(f)};
+	BOOST_CHECK(!f);
+	BOOST_CHECK_EQUAL(g(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(test_destruction)
+{
+	int instances = 0;
+	{
+		inline_function<int(int), 32> f{count_instances{instances}};
+		BOOST_CHECK_EQUAL(instances, 1);
+		inline_function<int(int), 32> g;
+		g = std::move(f);
+		BOOST_CHECK_EQUAL(instances, 1);
+		BOOST_CHECK_EQUAL(g(1), 2);
+		g = nullptr;
+		BOOST_CHECK_EQUAL(instances, 0);
+		inline_function<int(int), 2> on_heap{count_instances{instances}};
+		BOOST_CHECK_EQUAL(instances, 1);
+	}
+	BOOST_CHECK_EQUAL(instances, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_swap)
+{
+	inline_function<int(), 16> f{[] { return 1; }};
+	inline_function<int(), 16> g{[] { return 2; }};
+	swap(f, g);
+	BOOST_CHECK_EQUAL(f(), 2);
+	BOOST_CHECK_EQUAL(g(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,10 +1,14 @@
 #include <boost/test/unit_test.hpp>
 
 #include <flexcore/extended/base_node.hpp>
+#include <flexcore/extended/nodes/region_worker_node.hpp>
 #include <flexcore/infrastructure.hpp>
 
 // std
+#include <chrono>
 #include <memory>
+#include <string>
+#include <thread>
 
 BOOST_AUTO_TEST_SUITE( test_infrastructure )
 
@@ -16,6 +20,29 @@ struct null : fc::tree_base_node
 	explicit null(const fc::node_args& node)
 	: tree_base_node(node) {}
 };
+struct counter : fc::region_worker_node
+{
+	static constexpr auto default_name = "counter";
+	explicit counter(const fc::node_args& node)
+		: region_worker_node([this](){ out.fire(++count); }, node)
+		, out(this)
+	{
+	}
+	event_source<int> out;
+	int count = 0;
+};
+
+struct receiver : fc::tree_base_node
+{
+	static constexpr auto default_name = "receiver";
+	explicit receiver(const fc::node_args& node)
+		: tree_base_node(node)
+		, in(this, [this](int v){ last = v; })
+	{
+	}
+	event_sink<int> in;
+	int last = 0;
+};
 }
 
 /*
@@ -34,4 +61,48 @@ BOOST_AUTO_TEST_CASE(test_buildup)
 	BOOST_CHECK_EQUAL(test_node.name(), "null");
 }
 
+BOOST_AUTO_TEST_CASE(test_balanced_regions)
+{
+	using fc::thread::cycle_control;
+	fc::infrastructure test_is;
+	// the root region is due in tick 0 of medium_tick
+	fc::region_options options;
+	options.phase = 2 * cycle_control::fast_tick;
+	auto shifted = test_is.add_region("shifted", cycle_control::medium_tick, options);
+	BOOST_CHECK(shifted->get_phase() == 2 * cycle_control::fast_tick);
+
+	std::vector<std::shared_ptr<fc::parallel_region>> regions;
+	for (int i = 0; i != 8; ++i)
+		regions.push_back(test_is.add_balanced_region(
+				"region" + std::to_string(i), cycle_control::medium_tick));
+
+	const auto load = test_is.slot_load();
+	BOOST_CHECK_EQUAL(load.size(), 10);
+	for (auto slot : load)
+		BOOST_CHECK_EQUAL(slot, 1);
+}
+
+/*
+ * with region dependencies events pass from one region
+ * to another with the same tick rate within a single tick.
+ */
+BOOST_AUTO_TEST_CASE(test_region_dependencies)
+{
+	using fc::operator>>;
+	fc::infrastructure test_is;
+	auto producer = test_is.add_region("producer", fc::thread::cycle_control::fast_tick);
+	auto consumer = test_is.add_region("consumer", fc::thread::cycle_control::fast_tick);
+	auto& source = test_is.node_owner().make_child<counter>(producer);
+	auto& sink = test_is.node_owner().make_child<receiver>(consumer);
+	source.out >> [](int i){ return i; } >> sink.in;
+
+	test_is.use_region_dependencies();
+	test_is.start_scheduler();
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	test_is.stop_scheduler();
+
+	BOOST_CHECK_GT(source.count, 0);
+	BOOST_CHECK_EQUAL(sink.last, source.count);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -2,10 +2,15 @@
 
 #include <flexcore/extended/ports/node_aware.hpp>
 #include <flexcore/pure/pure_ports.hpp>
+#include <flexcore/ports.hpp>
 #include <flexcore/extended/base_node.hpp>
 #include <nodes/owning_node.hpp>
 #include <pure/sink_fixture.hpp>
 
+#include <atomic>
+#include <list>
+#include <thread>
+
 #include <boost/mpl/list.hpp>
 #include <boost/variant.hpp>
 
@@ -373,4 +378,70 @@ BOOST_AUTO_TEST_CASE(test_state_same_region)
 	BOOST_CHECK_EQUAL(sink.get(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(test_memoizing_state_source)
+{
+	int calls = 0;
+	auto& ticks = root.node().region()->ticks;
+	memoizing_state_source<int> source{&root.node(), [&calls]{ return ++calls; }};
+	state_sink<int> sink_1{&root.node()};
+	state_sink<int> sink_2{&root.node()};
+	source >> sink_1;
+	source >> sink_2;
+
+	BOOST_CHECK_EQUAL(sink_1.get(), 1);
+	BOOST_CHECK_EQUAL(sink_2.get(), 1);
+	ticks.in_work()();
+	BOOST_CHECK_EQUAL(sink_2.get(), 1);
+	ticks.switch_buffers();
+	BOOST_CHECK_EQUAL(sink_2.get(), 2);
+	BOOST_CHECK_EQUAL(source.hits(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_event_source)
+{
+	auto& ticks = root.node().region()->ticks;
+	concurrent_event_source<int> source{&root.node()};
+	int received = 0;
+	event_sink<int> sink{&root.node(), [&received](int in){ received = in; }};
+
+	source >> [](int in){ return in + 1; } >> sink;
+	source.fire(1);
+	BOOST_CHECK_EQUAL(received, 2);
+	source.disconnect(sink);
+	BOOST_CHECK_EQUAL(source.nr_connected_handlers(), 0);
+	source.fire(2);
+	BOOST_CHECK_EQUAL(received, 2);
+
+	// the port reclaims replaced connections on the reclaim tick, sent after the switch tick.
+	ticks.switch_buffers();
+	BOOST_CHECK_EQUAL(source.reclaim(), 0);
+
+	// ports can be created while the region is switched, but destroyed only after a reclaim.
+	std::list<concurrent_event_source<int>> runtime_sources;
+	std::atomic<bool> done{false};
+	std::thread switching{[&]
+	{
+		while (!done)
+			ticks.switch_buffers();
+	}};
+	for (int i = 0; i != 100; ++i)
+	{
+		runtime_sources.emplace_back(&root.node());
+		runtime_sources.back() >> sink;
+		runtime_sources.back().disconnect(sink);
+	}
+	done = true;
+	switching.join();
+	BOOST_CHECK_EQUAL(ticks.reclaim_tick().nr_connected_handlers(), runtime_sources.size() + 1);
+	runtime_sources.clear();
+	BOOST_CHECK_EQUAL(ticks.reclaim_tick().nr_connected_handlers(), 1);
+
+	// buffers to other regions would need to be connected to the ticks of the regions.
+	auto other_region = std::make_shared<parallel_region>("other",
+			thread::cycle_control::fast_tick);
+	tests::owning_node other_root(other_region);
+	event_sink<int> other_sink{&other_root.node(), [](int){}};
+	BOOST_CHECK_THROW(source >> other_sink, std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,8 @@
 #include <flexcore/extended/ports/connection_buffer.hpp>
 #include <flexcore/pure/pure_ports.hpp>
 
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(test_eventbuffer)
 
 using fc::operator>>;
@@ -84,4 +86,25 @@ BOOST_AUTO_TEST_CASE(test_event_buffer)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(test_reserved_event_buffer)
+{
+	fc::event_buffer<int> test_buffer{};
+	test_buffer.reserve(16);
+
+	std::vector<int> received;
+	fc::pure::event_sink<int> sink([&received](int i){ received.push_back(i); });
+	fc::pure::event_source<int> source{};
+	source >> test_buffer.in();
+	test_buffer.out() >> sink;
+
+	// more events than reserved are still buffered.
+	for (int i = 0; i != 20; ++i)
+		source.fire(i);
+	test_buffer.switch_active_tick()();
+	test_buffer.switch_passive_tick()();
+	test_buffer.work_tick()();
+	BOOST_CHECK_EQUAL(received.size(), 20);
+	BOOST_CHECK_EQUAL(received.back(), 19);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
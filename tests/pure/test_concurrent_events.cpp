@@ -0,0 +1,102 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/pure/concurrent_event_source.hpp>
+#include <flexcore/pure/event_sinks.hpp>
+#include <flexcore/pure/event_sources.hpp>
+#include <flexcore/core/connection.hpp>
+
+#include <tests/pure/sink_fixture.hpp>
+
+#include <atomic>
+#include <list>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(test_concurrent_events)
+
+using namespace fc;
+
+BOOST_AUTO_TEST_CASE( connect_and_disconnect )
+{
+	pure::concurrent_event_source<int> source;
+	pure::sink_fixture<int> fixture;
+	pure::event_sink<int> sink{[&fixture](int in){ fixture(in); }};
+
+	source >> [](int in){ return in * 2; } >> sink;
+	BOOST_CHECK_EQUAL(source.nr_connected_handlers(), 1);
+	source.fire(1);
+	fixture.expect(2);
+
+	source.disconnect(sink);
+	BOOST_CHECK_EQUAL(source.nr_connected_handlers(), 0);
+	source.fire(2);
+	// without reclaim tick, changes are reclaimed right away.
+	BOOST_CHECK_EQUAL(source.reclaim(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( reclaim_on_tick )
+{
+	pure::concurrent_event_source<int> source;
+	pure::event_source<void> tick;
+	tick >> source.reclaim_tick();
+	pure::event_sink<int> sink{[](int){}};
+
+	source >> sink;
+	source.disconnect(sink);
+	tick.fire();
+	BOOST_CHECK_EQUAL(source.reclaim(), 0);
+
+	source >> sink;
+	source.disconnect(sink);
+	BOOST_CHECK_EQUAL(source.reclaim(), 2);
+}
+
+BOOST_AUTO_TEST_CASE( destroyed_sinks_are_disconnected )
+{
+	pure::concurrent_event_source<int> source;
+	{
+		pure::event_sink<int> sink{[](int){}};
+		source >> sink;
+		source >> sink;
+		BOOST_CHECK_EQUAL(source.nr_connected_handlers(), 2);
+	}
+	BOOST_CHECK_EQUAL(source.nr_connected_handlers(), 0);
+
+	// disconnected sinks do not remove connections again, when they are destroyed.
+	pure::event_sink<int> other{[](int){}};
+	source >> other;
+	{
+		pure::event_sink<int> sink{[](int){}};
+		source >> sink;
+		source.disconnect(sink);
+	}
+	BOOST_CHECK_EQUAL(source.nr_connected_handlers(), 1);
+}
+
+BOOST_AUTO_TEST_CASE( connect_while_firing )
+{
+	constexpr int nr_of_sinks = 100;
+	pure::concurrent_event_source<void> source;
+	pure::event_source<void> tick;
+	tick >> source.reclaim_tick();
+	std::list<std::atomic<int>> counters(nr_of_sinks);
+
+	std::atomic<bool> done{false};
+	std::thread firing{[&]
+	{
+		while (!done)
+			source.fire();
+	}};
+
+	for (auto& counter : counters)
+		source >> [&counter]{ ++counter; };
+	for (auto& counter : counters)
+		while (counter == 0)
+			std::this_thread::yield();
+
+	done = true;
+	firing.join();
+	BOOST_CHECK_EQUAL(source.reclaim(), nr_of_sinks);
+	BOOST_CHECK_EQUAL(source.nr_connected_handlers(), nr_of_sinks);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,10 +2,15 @@
 
 #include <flexcore/pure/event_sinks.hpp>
 #include <flexcore/pure/event_sources.hpp>
+#include <flexcore/pure/static_ports.hpp>
 #include <flexcore/core/connection.hpp>
 
 #include <tests/pure/sink_fixture.hpp>
 
+#include <array>
+#include <memory>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(test_events)
 
 using namespace fc;
@@ -342,4 +347,133 @@ BOOST_AUTO_TEST_CASE( type_changing_lambda_with_void )
 	BOOST_CHECK(called_2);
 }
 
+//connections larger than the inline storage of ports are stored on the heap.
+BOOST_AUTO_TEST_CASE( large_connection )
+{
+	pure::event_source<int> src{};
+	pure::sink_fixture<int> sink;
+	std::array<int, 64> offsets{};
+	offsets.back() = 1;
+	static_assert(sizeof(offsets) > detail::port_handler_capacity,
+			"connection needs to exceed inline storage");
+	src >> [offsets](int in) { return in + offsets.back(); } >> sink;
+	src >> [](int in) { return in; } >> sink;
+
+	src.fire(1);
+	sink.expect(2);
+	sink.expect(1);
+}
+
+BOOST_AUTO_TEST_CASE( fire_batch )
+{
+	pure::event_source<int> src{};
+	std::vector<size_t> batch_sizes;
+	pure::event_sink<int> batch_sink{[&batch_sizes](span<const int> events)
+	{
+		batch_sizes.push_back(events.size());
+	}};
+	BOOST_CHECK(batch_sink.accepts_batches());
+	pure::sink_fixture<int> sink{1, 2, 3, 2};
+
+	src >> batch_sink;
+	src >> [](int in) { return in; } >> sink; // falls back to single events
+
+	const std::vector<int> events{1, 2, 3};
+	src.fire_batch(events);
+	src.fire(2); // batch of one for batch_sink
+
+	BOOST_CHECK_EQUAL(batch_sizes.size(), 2);
+	BOOST_CHECK_EQUAL(batch_sizes.front(), 3);
+	BOOST_CHECK_EQUAL(batch_sizes.back(), 1);
+}
+
+// connections without batch handler receive the events of a batch as calls of fire would.
+BOOST_AUTO_TEST_CASE( fire_batch_keeps_interleaving )
+{
+	pure::event_source<int> src{};
+	std::vector<int> order;
+	size_t batched = 0;
+	pure::event_sink<int> batch_sink{[&](span<const int> events)
+	{
+		BOOST_CHECK(order.empty());
+		batched += events.size();
+	}};
+	src >> [&order](int in) { order.push_back(in); };
+	src >> batch_sink;
+	src >> [&order](int in) { order.push_back(-in); };
+
+	src.fire_batch(std::vector<int>{1, 2, 3});
+	BOOST_CHECK_EQUAL(batched, 3);
+	BOOST_CHECK((order == std::vector<int>{1, -1, 2, -2, 3, -3}));
+}
+
+BOOST_AUTO_TEST_CASE( fire_batch_void )
+{
+	pure::event_source<void> src{};
+	size_t batched = 0;
+	int single = 0;
+	pure::event_sink<void> batch_sink{[&batched](size_t count) { batched += count; }};
+	pure::event_sink<void> sink{[&single]() { ++single; }};
+	BOOST_CHECK(!sink.accepts_batches());
+	src >> batch_sink;
+	src >> sink;
+
+	src.fire_batch(3);
+	src.fire();
+	BOOST_CHECK_EQUAL(batched, 4);
+	BOOST_CHECK_EQUAL(single, 4);
+}
+
+// sinks of batches behind connections receive single events as batches of one
+BOOST_AUTO_TEST_CASE( batch_sink_behind_connection )
+{
+	pure::event_source<int> src{};
+	std::vector<int> received;
+	pure::event_sink<int> batch_sink{[&received](span<const int> events)
+	{
+		BOOST_CHECK_EQUAL(events.size(), 1);
+		received.insert(received.end(), events.begin(), events.end());
+	}};
+	src >> [](int in) { return in * 2; } >> batch_sink;
+	src.fire(1);
+	src.fire_batch(std::vector<int>{2, 3});
+	BOOST_CHECK((received == std::vector<int>{2, 4, 6}));
+
+	auto direct = pure::make_static_event_source<int>(batch_sink);
+	direct.fire(4);
+	BOOST_CHECK_EQUAL(received.back(), 4);
+
+	size_t batched = 0;
+	pure::event_sink<void> void_sink{[&batched](size_t count) { batched += count; }};
+	auto tick = pure::make_static_event_source<void>(void_sink);
+	tick.fire();
+	tick.fire();
+	BOOST_CHECK_EQUAL(batched, 2);
+}
+
+//destroying sinks keeps the order of the remaining connections
+BOOST_AUTO_TEST_CASE( disconnect_keeps_order )
+{
+	pure::event_source<int> src{};
+	std::vector<int> received;
+	auto first = std::make_unique<pure::event_sink<int>>([&received](int){ received.push_back(1); });
+	auto second = std::make_unique<pure::event_sink<int>>([&received](int){ received.push_back(2); });
+	pure::event_sink<int> third{[&received](int){ received.push_back(3); }};
+	src >> *first;
+	src >> *second;
+	src >> third;
+
+	second.reset();
+	src.fire(0);
+	BOOST_CHECK((received == std::vector<int>{1, 3}));
+
+	first.reset();
+	pure::event_sink<int> fourth{[&received](int){ received.push_back(4); }};
+	src >> fourth;
+	received.clear();
+	src.fire(0);
+	BOOST_CHECK((received == std::vector<int>{3, 4}));
+	BOOST_CHECK_EQUAL(src.nr_connected_handlers(), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -33,6 +33,18 @@ public:
 private:
 	std::string value_;
 };
+
+/// token which counts how often it is copied.
+struct copy_counter
+{
+	explicit copy_counter(int& copies) : copies(&copies) {}
+	copy_counter(const copy_counter& other) : copies(other.copies) { ++*copies; }
+	copy_counter(copy_counter&&) = default;
+	copy_counter& operator=(const copy_counter& other) = default;
+	copy_counter& operator=(copy_counter&&) = default;
+
+	int* copies;
+};
 }
 BOOST_AUTO_TEST_CASE( move_token_ )
 {
@@ -98,4 +110,43 @@ BOOST_AUTO_TEST_CASE( non_moving )
 	BOOST_CHECK(!moved);
 }
 
+//only connections but the last receive copies of fired rvalues
+BOOST_AUTO_TEST_CASE( move_to_last_connection )
+{
+	int copies = 0;
+	pure::event_source<copy_counter> source{};
+	const auto sink = [](const copy_counter&){};
+
+	source >> sink;
+	source.fire(copy_counter{copies});
+	BOOST_CHECK_EQUAL(copies, 0);
+
+	source >> sink;
+	source >> sink;
+	source.fire(copy_counter{copies});
+	BOOST_CHECK_EQUAL(copies, 2);
+
+	copies = 0;
+	const copy_counter lvalue{copies};
+	source.fire(lvalue);
+	BOOST_CHECK_EQUAL(copies, 3);
+}
+
+BOOST_AUTO_TEST_CASE( shared_payload_fan_out )
+{
+	using payload_t = pure::shared_payload<std::vector<int>>;
+	pure::event_source<payload_t> source{};
+	std::vector<const std::vector<int>*> received;
+	for (int i = 0; i != 4; ++i)
+		source >> [&received](const payload_t& p){ received.push_back(&p.get()); };
+
+	auto payload = pure::make_shared_payload<std::vector<int>>(1000, 1);
+	const auto* data = &payload.get();
+	source.fire(std::move(payload));
+
+	BOOST_CHECK_EQUAL(received.size(), 4);
+	for (const auto* r : received)
+		BOOST_CHECK_EQUAL(r, data);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
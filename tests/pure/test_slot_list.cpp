@@ -0,0 +1,55 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/pure/detail/slot_list.hpp>
+
+#include <iterator>
+#include <vector>
+
+using fc::detail::slot_list;
+
+BOOST_AUTO_TEST_SUITE(test_slot_list)
+
+namespace
+{
+std::vector<int> values(const slot_list<int>& list)
+{
+	return std::vector<int>(list.begin(), list.end());
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_insertion_order)
+{
+	slot_list<int> list;
+	BOOST_CHECK(list.empty());
+	const auto first = list.push_back(1);
+	const auto second = list.push_back(2);
+	list.push_back(3);
+	BOOST_CHECK_EQUAL(list.size(), 3);
+
+	list.erase(second);
+	BOOST_CHECK((values(list) == std::vector<int>{1, 3}));
+	list.erase(first);
+	BOOST_CHECK((values(list) == std::vector<int>{3}));
+
+	// freed slots are reused, but new values are still appended.
+	list.push_back(4);
+	list.push_back(5);
+	BOOST_CHECK((values(list) == std::vector<int>{3, 4, 5}));
+	BOOST_CHECK_EQUAL(*std::prev(list.end()), 5);
+	BOOST_CHECK_EQUAL(list.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_stale_handles)
+{
+	slot_list<int> list;
+	const auto removed = list.push_back(1);
+	list.erase(removed);
+	const auto reused = list.push_back(2);
+	BOOST_CHECK(!list.contains(removed));
+	BOOST_CHECK(list.contains(reused));
+
+	list.erase(removed); // does not remove the value in the reused slot
+	BOOST_CHECK((values(list) == std::vector<int>{2}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
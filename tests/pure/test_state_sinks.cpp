@@ -2,7 +2,11 @@
 
 #include <flexcore/pure/state_sink.hpp>
 #include <flexcore/pure/state_sources.hpp>
+#include <flexcore/pure/versioned_state.hpp>
 #include <flexcore/core/connection.hpp>
+#include <flexcore/scheduler/parallelregion.hpp>
+
+#include <string>
 
 using namespace fc;
 
@@ -150,4 +154,60 @@ BOOST_AUTO_TEST_CASE(state_source_connect_after_move)
 	BOOST_CHECK_THROW(sink.get(), std::bad_function_call);
 }
 
+BOOST_AUTO_TEST_CASE(memoizing_state_source)
+{
+	tick_controller ticks;
+	int calls = 0;
+	pure::memoizing_state_source<int> source{ticks.generation(), [&calls] { return ++calls; }};
+	pure::state_sink<int> sink_1{};
+	pure::state_sink<int> sink_2{};
+	source >> sink_1;
+	source >> [](int in) { return in * 10; } >> sink_2;
+
+	BOOST_CHECK_EQUAL(sink_1.get(), 1);
+	BOOST_CHECK_EQUAL(sink_2.get(), 10);
+	BOOST_CHECK_EQUAL(source.misses(), 1);
+	BOOST_CHECK_EQUAL(source.hits(), 1);
+
+	ticks.in_work()(); // the work tick of the same tick keeps the cache
+	BOOST_CHECK_EQUAL(sink_1.get(), 1);
+	ticks.switch_buffers(); // every tick invalidates the cache
+	BOOST_CHECK_EQUAL(sink_2.get(), 20);
+	BOOST_CHECK_EQUAL(sink_1.get(), 2);
+	BOOST_CHECK_EQUAL(source.misses(), 2);
+	BOOST_CHECK_EQUAL(source.hits(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(incremental_state_chain)
+{
+	pure::versioned_state_source<int> source{1};
+	int parity_calls = 0;
+	int text_calls = 0;
+	pure::state_sink<pure::versioned<std::string>> sink{};
+	source
+			>> pure::incremental<int>([&parity_calls](int in)
+				{ ++parity_calls; return in % 2; })
+			>> pure::incremental<int>([&text_calls](int in)
+				{ ++text_calls; return in == 0 ? std::string{"even"} : std::string{"odd"}; })
+			>> sink;
+
+	BOOST_CHECK_EQUAL(sink.get().get(), "odd");
+	const auto first_version = sink.get().version;
+	BOOST_CHECK_EQUAL(parity_calls, 1);
+	BOOST_CHECK_EQUAL(text_calls, 1);
+
+	// same parity, the text is not recomputed and keeps its version.
+	source.set(3);
+	BOOST_CHECK_EQUAL(sink.get().get(), "odd");
+	BOOST_CHECK_EQUAL(sink.get().version, first_version);
+	BOOST_CHECK_EQUAL(parity_calls, 2);
+	BOOST_CHECK_EQUAL(text_calls, 1);
+
+	source.set(4);
+	BOOST_CHECK_EQUAL(sink.get().get(), "even");
+	BOOST_CHECK(sink.get().version != first_version);
+	BOOST_CHECK_EQUAL(parity_calls, 3);
+	BOOST_CHECK_EQUAL(text_calls, 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,55 @@
+#include <boost/test/unit_test.hpp>
+
+#include <flexcore/pure/static_ports.hpp>
+#include <flexcore/pure/event_sinks.hpp>
+#include <flexcore/pure/state_sources.hpp>
+#include <flexcore/core/connection.hpp>
+
+#include <tests/pure/sink_fixture.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(test_static_ports)
+
+using namespace fc;
+
+BOOST_AUTO_TEST_CASE( static_event_chains )
+{
+	pure::sink_fixture<int> sink;
+	pure::event_sink<int> port_sink{[&sink](int in){ sink(in); }};
+	auto source = pure::make_static_event_source<int>(
+			[](int in){ return in + 1; } >> [](int in){ return in * 2; } >> sink,
+			[](int in){ return in - 1; } >> port_sink);
+	static_assert(decltype(source)::nr_connected_handlers() == 2, "");
+
+	source.fire(1);
+	sink.expect(4);
+	sink.expect(0);
+}
+
+BOOST_AUTO_TEST_CASE( handlers_called_in_order )
+{
+	std::vector<int> calls;
+	auto source = pure::make_static_event_source<void>(
+			[&calls]{ calls.push_back(1); });
+	auto extended = std::move(source).connect([&calls]{ calls.push_back(2); });
+	static_assert(decltype(extended)::nr_connected_handlers() == 2, "");
+
+	extended.fire();
+	BOOST_CHECK_EQUAL(calls.size(), 2);
+	BOOST_CHECK_EQUAL(calls.front(), 1);
+	BOOST_CHECK_EQUAL(calls.back(), 2);
+}
+
+BOOST_AUTO_TEST_CASE( static_state_chain )
+{
+	int state = 1;
+	pure::state_source<int> source{[&state]{ return state; }};
+	auto sink = pure::make_static_state_sink<int>(source >> [](int in){ return in * 3; });
+
+	BOOST_CHECK_EQUAL(sink.get(), 3);
+	state = 2;
+	BOOST_CHECK_EQUAL(sink.get(), 6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
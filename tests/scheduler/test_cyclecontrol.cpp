@@ -10,10 +10,16 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iomanip>
 #include <ctime>
 #include <future>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
 #include <unistd.h>
 
 using namespace fc;
@@ -60,7 +66,454 @@ BOOST_AUTO_TEST_CASE(test_adding_tasks_to_running_scheduler)
 	controller.start();
 	BOOST_CHECK_THROW(controller.add_task(sched::periodic_task{[]{}}, sched::cycle_control::fast_tick), std::runtime_error);
 	controller.stop();
-	BOOST_CHECK_THROW(controller.add_task(sched::periodic_task{[]{}}, 2 * sched::cycle_control::slow_tick), std::invalid_argument);
+	controller.add_task(sched::periodic_task{[]{}}, 2 * sched::cycle_control::slow_tick);
+	BOOST_CHECK_THROW(controller.add_task(sched::periodic_task{[]{}},
+			sched::cycle_control::fast_tick + std::chrono::milliseconds(5)), std::invalid_argument);
+	BOOST_CHECK_THROW(controller.add_task(sched::periodic_task{[]{}},
+			virtual_clock::duration::zero()), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_set_min_tick_length)
+{
+	namespace sched = fc::thread;
+	using std::chrono::milliseconds;
+	sched::cycle_control controller{std::make_unique<sched::parallel_scheduler>()};
+	BOOST_CHECK(controller.get_min_tick_length() == sched::cycle_control::min_tick_length);
+	controller.add_task(sched::periodic_task{[]{}}, milliseconds(20));
+	BOOST_CHECK_THROW(controller.set_min_tick_length(milliseconds(3)), std::invalid_argument);
+	BOOST_CHECK_THROW(controller.set_min_tick_length(milliseconds(0)), std::invalid_argument);
+	controller.set_min_tick_length(milliseconds(5));
+	BOOST_CHECK(controller.get_min_tick_length() == milliseconds(5));
+	controller.add_task(sched::periodic_task{[]{}}, milliseconds(15));
+}
+
+BOOST_AUTO_TEST_CASE(test_arbitrary_tick_rates)
+{
+	namespace sched = fc::thread;
+	using std::chrono::milliseconds;
+	sched::cycle_control controller{std::make_unique<sched::parallel_scheduler>(),
+		[](auto& task)
+		{
+			return task.wait_until_done(sched::cycle_control::slow_tick);
+		},
+		std::make_shared<sched::afap_main_loop>()};
+	controller.set_min_tick_length(milliseconds(1));
+
+	const std::vector<int> periods{1, 2, 5, 20, 250, 2000};
+	std::vector<std::atomic<int>> counters(periods.size());
+	for (size_t i = 0; i != periods.size(); ++i)
+	{
+		counters[i] = 0;
+		controller.add_task(sched::periodic_task{[&counters, i]{ ++counters[i]; }},
+				milliseconds(periods[i]));
+	}
+
+	// every window of 2000 ticks contains exactly 2000 / period ticks of each task.
+	constexpr int nr_of_ticks = 2000;
+	for (int i = 0; i != nr_of_ticks; ++i)
+		controller.work();
+	controller.stop();
+
+	for (size_t i = 0; i != periods.size(); ++i)
+		BOOST_CHECK_EQUAL(counters[i].load(), nr_of_ticks / periods[i]);
+}
+
+BOOST_AUTO_TEST_CASE(test_phase_offsets)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	using std::chrono::milliseconds;
+	sched::cycle_control controller{std::make_unique<sched::parallel_scheduler>(),
+		[](auto& task)
+		{
+			return task.wait_until_done(cycle::slow_tick);
+		},
+		std::make_shared<sched::afap_main_loop>()};
+
+	BOOST_CHECK_THROW(controller.add_task(sched::periodic_task{[]{}},
+			cycle::medium_tick, cycle::medium_tick), std::invalid_argument);
+	BOOST_CHECK_THROW(controller.add_task(sched::periodic_task{[]{}},
+			cycle::medium_tick, milliseconds(15)), std::invalid_argument);
+
+	std::vector<virtual_clock::steady::time_point> starts;
+	controller.add_task(sched::periodic_task{[]{}}, cycle::medium_tick);
+	controller.add_task(sched::periodic_task{[&starts]
+			{
+				starts.push_back(virtual_clock::steady::now());
+			}}, cycle::medium_tick, milliseconds(50));
+
+	const std::vector<size_t> expected_load{1, 0, 0, 0, 0, 1, 0, 0, 0, 0};
+	const auto load = controller.slot_load();
+	BOOST_CHECK_EQUAL_COLLECTIONS(load.begin(), load.end(),
+			expected_load.begin(), expected_load.end());
+	BOOST_CHECK(controller.least_loaded_phase(cycle::medium_tick) == milliseconds(10));
+
+	// wait for tasks after each tick, such that they see the clock of their own tick.
+	for (int i = 0; i != 100; ++i)
+	{
+		controller.work();
+		controller.stop();
+	}
+
+	BOOST_CHECK_EQUAL(starts.size(), 10);
+	for (auto start : starts)
+	{
+		// the clock has already been advanced by a single tick when the task runs.
+		const auto due = start.time_since_epoch() - cycle::min_tick_length;
+		BOOST_CHECK(due % cycle::medium_tick == milliseconds(50));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(test_skip_idle_ticks)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	using std::chrono::milliseconds;
+	sched::cycle_control controller{std::make_unique<sched::parallel_scheduler>(),
+		[](auto& task)
+		{
+			return task.wait_until_done(cycle::slow_tick);
+		},
+		std::make_shared<sched::afap_main_loop>()};
+
+	// without tasks there is nothing to skip to.
+	const auto begin = controller.get_clock().steady_now();
+	controller.skip_idle_ticks();
+	BOOST_CHECK(controller.get_clock().steady_now() == begin);
+
+	std::vector<virtual_clock::steady::time_point> slow_starts;
+	std::vector<virtual_clock::steady::time_point> medium_starts;
+	controller.add_task(sched::periodic_task{[&slow_starts]
+			{
+				slow_starts.push_back(virtual_clock::steady::now());
+			}}, cycle::slow_tick, milliseconds(30));
+	controller.add_task(sched::periodic_task{[&medium_starts]
+			{
+				medium_starts.push_back(virtual_clock::steady::now());
+			}}, cycle::medium_tick, milliseconds(70));
+
+	int iterations = 0;
+	while (slow_starts.size() != 3)
+	{
+		controller.skip_idle_ticks();
+		controller.work();
+		controller.stop();
+		++iterations;
+	}
+
+	// only ticks with due tasks are visited, one slow tick contains ten medium ticks.
+	BOOST_CHECK_EQUAL(medium_starts.size() + slow_starts.size(), iterations);
+	BOOST_CHECK(medium_starts.size() >= 20);
+	for (auto start : slow_starts)
+	{
+		const auto due = start.time_since_epoch() - cycle::min_tick_length;
+		BOOST_CHECK(due % cycle::slow_tick == milliseconds(30));
+	}
+	for (size_t i = 1; i < medium_starts.size(); ++i)
+	{
+		BOOST_CHECK(medium_starts[i] - medium_starts[i - 1] == cycle::medium_tick);
+		const auto due = medium_starts[i].time_since_epoch() - cycle::min_tick_length;
+		BOOST_CHECK(due % cycle::medium_tick == milliseconds(70));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(test_independent_clocks)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	auto make_control = []
+	{
+		return std::make_unique<cycle>(std::make_unique<sched::parallel_scheduler>(),
+				[](auto& task){ return task.wait_until_done(cycle::slow_tick); },
+				std::make_shared<sched::afap_main_loop>());
+	};
+	auto first = make_control();
+	auto second = make_control();
+	auto region = std::make_shared<parallel_region>("region", cycle::fast_tick);
+	BOOST_CHECK(&region->get_clock() == &virtual_clock::global());
+
+	virtual_clock::steady::time_point seen_by_task{};
+	first->add_task(sched::periodic_task{[&seen_by_task]
+			{
+				seen_by_task = virtual_clock::steady::now();
+			}}, cycle::fast_tick);
+	second->add_task(sched::periodic_task{region}, cycle::fast_tick);
+	BOOST_CHECK(&region->get_clock() == &second->get_clock());
+
+	const auto global_time = virtual_clock::global().steady_now();
+	for (int i = 0; i != 10; ++i)
+	{
+		first->work();
+		first->stop();
+	}
+	for (int i = 0; i != 3; ++i)
+	{
+		second->work();
+		second->stop();
+	}
+
+	BOOST_CHECK(first->get_clock().steady_now().time_since_epoch() == cycle::fast_tick * 10);
+	BOOST_CHECK(second->get_clock().steady_now().time_since_epoch() == cycle::fast_tick * 3);
+	BOOST_CHECK(seen_by_task == first->get_clock().steady_now());
+	BOOST_CHECK(virtual_clock::global().steady_now() == global_time);
+	BOOST_CHECK(virtual_clock::steady::now() == global_time);
+
+	{
+		const virtual_clock::scope scope{&second->get_clock()};
+		BOOST_CHECK(virtual_clock::steady::now() == second->get_clock().steady_now());
+	}
+	BOOST_CHECK(virtual_clock::steady::now() == global_time);
+}
+
+BOOST_AUTO_TEST_CASE(test_region_dependencies)
+{
+	namespace sched = fc::thread;
+	using cycle = sched::cycle_control;
+	sched::cycle_control controller{std::make_unique<sched::parallel_scheduler>(),
+		[](auto& task)
+		{
+			return task.wait_until_done(cycle::slow_tick);
+		},
+		std::make_shared<sched::afap_main_loop>()};
+
+	constexpr int nr_of_regions = 4;
+	std::vector<std::shared_ptr<parallel_region>> regions;
+	std::atomic<int> sequence{0};
+	std::vector<int> order(nr_of_regions, -1);
+	// switch ticks are sent by the thread calling work, before any region is started.
+	const auto main_thread = std::this_thread::get_id();
+	std::atomic<int> late_switches{0};
+	for (int i = 0; i != nr_of_regions; ++i)
+	{
+		auto region = std::make_shared<parallel_region>("r" + std::to_string(i), cycle::fast_tick);
+		region->switch_tick() >> [&sequence, &late_switches, main_thread]
+		{
+			if (sequence != 0 || std::this_thread::get_id() != main_thread)
+				++late_switches;
+		};
+		region->work_tick() >> [&order, &sequence, i]{ order[i] = sequence++; };
+		controller.add_task(sched::periodic_task{region}, cycle::fast_tick);
+		regions.push_back(region);
+	}
+
+	// chain in reverse order of insertion, region 3 is independent
+	controller.set_region_dependencies({
+			{regions[2].get(), regions[1].get()},
+			{regions[1].get(), regions[0].get()}});
+	for (int tick = 0; tick != 10; ++tick)
+	{
+		sequence = 0;
+		controller.work();
+		controller.stop();
+		BOOST_CHECK_LT(order[2], order[1]);
+		BOOST_CHECK_LT(order[1], order[0]);
+		BOOST_CHECK_NE(order[3], -1);
+	}
+
+	// regions in a cycle are started together
+	controller.set_region_dependencies({
+			{regions[0].get(), regions[1].get()},
+			{regions[1].get(), regions[0].get()},
+			{regions[1].get(), regions[2].get()}});
+	std::fill(order.begin(), order.end(), -1);
+	sequence = 0;
+	controller.work();
+	controller.stop();
+	BOOST_CHECK_LT(order[0], order[2]);
+	BOOST_CHECK_LT(order[1], order[2]);
+	BOOST_CHECK_NE(order[3], -1);
+	BOOST_CHECK_EQUAL(late_switches.load(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_tick_barrier)
+{
+	using std::chrono::milliseconds;
+	fc::thread::detail::tick_barrier barrier;
+	BOOST_CHECK(barrier.done());
+	barrier.add(2);
+	BOOST_CHECK(!barrier.done());
+	BOOST_CHECK(!barrier.wait_until(wall_clock::steady::now() + milliseconds(1)));
+
+	std::thread worker{[&barrier]
+	{
+		std::this_thread::sleep_for(milliseconds(5));
+		barrier.arrive();
+		barrier.arrive();
+	}};
+	BOOST_CHECK(barrier.wait_until(wall_clock::steady::now() + std::chrono::seconds(10)));
+	BOOST_CHECK(barrier.done());
+	worker.join();
+}
+
+BOOST_AUTO_TEST_CASE(test_realtime_settings)
+{
+	std::atomic<int> counter{0};
+	thread::cycle_control control{std::make_unique<thread::parallel_scheduler>(),
+			std::make_shared<thread::afap_main_loop>()};
+	control.add_task(thread::periodic_task{[&counter]{ ++counter; }},
+			thread::cycle_control::fast_tick);
+
+	thread::realtime_settings settings;
+	settings.prefault_stack = 64 * 1024;
+	settings.prefault_heap = 1024 * 1024;
+	control.set_realtime_settings(settings);
+	BOOST_CHECK_EQUAL(control.get_realtime_settings().prefault_heap, settings.prefault_heap);
+
+	control.start();
+	BOOST_CHECK_THROW(control.set_realtime_settings(settings), std::runtime_error);
+	while (counter.load() < 10)
+		std::this_thread::yield();
+	control.stop();
+
+	// real-time priorities require privileges, without them start fails and nothing runs.
+	settings.main_loop_priority = 1;
+	settings.worker_priority = 1;
+	control.set_realtime_settings(settings);
+	try
+	{
+		control.start();
+		control.stop();
+	}
+	catch (const std::system_error&)
+	{
+		const int stopped_count = counter.load();
+		control.set_realtime_settings(thread::realtime_settings{});
+		control.start();
+		while (counter.load() == stopped_count)
+			std::this_thread::yield();
+		control.stop();
+	}
+	BOOST_CHECK(counter.load() >= 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_precise_realtime_main_loop)
+{
+	using namespace std::chrono_literals;
+	auto loop = std::make_shared<thread::precise_realtime_main_loop>(200us);
+	// on a loaded machine a tick might be missed, which must not stop the loop here.
+	thread::cycle_control control{std::make_unique<thread::parallel_scheduler>(),
+			[](auto&){ return true; }, loop};
+	control.set_min_tick_length(1ms);
+	BOOST_CHECK(loop->tick_length == 1ms);
+
+	std::atomic<int> counter{0};
+	control.add_task(thread::periodic_task{[&counter]{ ++counter; }}, 1ms);
+	const auto begin = wall_clock::steady::now();
+	control.start();
+	while (counter.load() < 50)
+		std::this_thread::sleep_for(1ms);
+	control.stop();
+	const auto elapsed = wall_clock::steady::now() - begin;
+
+	// the loop neither runs faster than real time nor misses most ticks.
+	BOOST_CHECK(elapsed >= 49ms);
+	const auto& lateness = control.main_loop_lateness();
+	BOOST_CHECK(lateness.count() >= 50);
+	BOOST_CHECK(lateness.max() >= lateness.mean());
+	BOOST_TEST_MESSAGE("mean lateness: "
+			<< std::chrono::duration_cast<std::chrono::microseconds>(lateness.mean()).count()
+			<< "us, max lateness: "
+			<< std::chrono::duration_cast<std::chrono::microseconds>(lateness.max()).count() << "us");
+}
+
+BOOST_AUTO_TEST_CASE(test_precise_realtime_main_loop_resyncs)
+{
+	using namespace std::chrono_literals;
+	thread::precise_realtime_main_loop loop{200us};
+	loop.tick_length = 1ms;
+	loop.arm();
+
+	// after a tick overran by several ticks, the loop does not catch up with a burst of ticks.
+	loop.loop_body([]{ std::this_thread::sleep_for(5ms); });
+	BOOST_CHECK_EQUAL(loop.get_wakeup_lateness().count(), 1);
+	BOOST_CHECK(loop.get_wakeup_lateness().max() >= 3ms);
+	const auto begin = wall_clock::steady::now();
+	for (int i = 0; i != 3; ++i)
+		loop.loop_body([]{});
+	BOOST_CHECK(wall_clock::steady::now() - begin >= 2ms);
+}
+
+BOOST_AUTO_TEST_CASE(test_region_statistics)
+{
+	using std::chrono::milliseconds;
+	thread::cycle_control control{std::make_unique<thread::parallel_scheduler>(),
+		[](auto& task){ return task.wait_until_done(thread::cycle_control::slow_tick); },
+		std::make_shared<thread::afap_main_loop>(false)};
+	auto region = std::make_shared<parallel_region>("region",
+			thread::cycle_control::fast_tick);
+	auto other = std::make_shared<parallel_region>("other",
+			thread::cycle_control::fast_tick);
+	region->work_tick() >> []{ std::this_thread::sleep_for(milliseconds(1)); };
+	control.add_task(thread::periodic_task{region}, thread::cycle_control::medium_tick);
+	BOOST_CHECK_THROW(control.region_statistics(*other), std::invalid_argument);
+
+	// the first tick is due at the start, every tenth tick is due afterwards.
+	for (int i = 0; i != 21; ++i)
+	{
+		control.work();
+		control.stop();
+	}
+	const auto& statistics = control.region_statistics(*region);
+	BOOST_CHECK_EQUAL(statistics.work_duration.count(), 3);
+	BOOST_CHECK_EQUAL(statistics.dispatch_latency.count(), 3);
+	BOOST_CHECK(statistics.work_duration.min() >= milliseconds(1));
+	BOOST_CHECK(statistics.work_duration.percentile(50.0) >= milliseconds(1));
+	// without sleeping the loop is not waiting for a tick.
+	BOOST_CHECK_EQUAL(control.main_loop_lateness().count(), 0);
+}
+
+namespace
+{
+/// runs tasks immediately on add and records their deadlines.
+struct recording_scheduler : thread::scheduler
+{
+	void add_task(task_t task) override { task(); }
+	void add_task(task_t task, const thread::task_properties& properties) override
+	{
+		deadlines.push_back(properties.deadline);
+		task();
+	}
+	void stop() override {}
+	size_t nr_of_waiting_tasks() const override { return 0; }
+
+	std::vector<wall_clock::steady::time_point> deadlines;
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_dispatch_in_deadline_order)
+{
+	using cycle = thread::cycle_control;
+	auto scheduler = std::make_unique<recording_scheduler>();
+	auto& recorded = scheduler->deadlines;
+	cycle control{std::move(scheduler)};
+	auto slow = std::make_shared<parallel_region>("slow", cycle::slow_tick);
+	auto fast = std::make_shared<parallel_region>("fast", cycle::fast_tick);
+	// the slow region is added first, but due later.
+	control.add_task(thread::periodic_task{slow}, cycle::slow_tick);
+	control.add_task(thread::periodic_task{fast}, cycle::fast_tick);
+
+	// deadlines are only passed on for regions, which enable them.
+	control.work();
+	BOOST_REQUIRE_EQUAL(recorded.size(), 2);
+	BOOST_CHECK(recorded[0] == wall_clock::steady::time_point::max());
+	BOOST_CHECK(recorded[1] == wall_clock::steady::time_point::max());
+
+	slow->set_deadline_scheduling(true);
+	fast->set_deadline_scheduling(true);
+	// the tasks run while they are added, thus the work ticks record the order of dispatch.
+	std::vector<std::string> dispatched;
+	slow->work_tick() >> [&dispatched]{ dispatched.push_back("slow"); };
+	fast->work_tick() >> [&dispatched]{ dispatched.push_back("fast"); };
+	// both regions are due again after a slow tick.
+	for (int tick = 1; tick != cycle::slow_tick / cycle::fast_tick; ++tick)
+		control.work();
+	recorded.clear();
+	dispatched.clear();
+	control.work();
+	BOOST_REQUIRE_EQUAL(recorded.size(), 2);
+	BOOST_CHECK((dispatched == std::vector<std::string>{"fast", "slow"}));
+	BOOST_CHECK(recorded[0] < recorded[1]);
+	BOOST_CHECK(recorded[1] != wall_clock::steady::time_point::max());
 }
 
 BOOST_AUTO_TEST_CASE(test_fast_main_loop)
@@ -81,12 +534,12 @@ BOOST_AUTO_TEST_CASE(test_fast_main_loop)
 	std::atomic_bool slow_done{false};
 	controller.add_task(sched::periodic_task{[&] { ++count_fast; }}, cycle::fast_tick);
 	controller.add_task(sched::periodic_task{[&] { ++count_medium; }}, cycle::medium_tick);
-	controller.add_task(sched::periodic_task{[&, b=false]() mutable {
+	// the clock of the controller starts at zero, where all tasks are due at once.
+	// thus wait for the second slow tick to have a full slow period in the counts.
+	controller.add_task(sched::periodic_task{[&]() {
 		++count_slow;
-		if (!b) {
+		if (count_slow == 2)
 			slow_done.store(true);
-			b = true;
-		}
 	}}, cycle::slow_tick);
 	controller.start();
 	while (!slow_done.load())
@@ -0,0 +1,73 @@
+#include <flexcore/scheduler/histogram.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+using namespace fc;
+
+BOOST_AUTO_TEST_SUITE(test_histogram)
+
+BOOST_AUTO_TEST_CASE(test_empty_histogram)
+{
+	thread::latency_histogram histogram;
+	BOOST_CHECK_EQUAL(histogram.count(), 0);
+	BOOST_CHECK(histogram.min() == thread::latency_histogram::duration::zero());
+	BOOST_CHECK(histogram.max() == thread::latency_histogram::duration::zero());
+	BOOST_CHECK(histogram.mean() == thread::latency_histogram::duration::zero());
+	BOOST_CHECK(histogram.percentile(99.0) == thread::latency_histogram::duration::zero());
+}
+
+BOOST_AUTO_TEST_CASE(test_percentiles)
+{
+	using std::chrono::microseconds;
+	using std::chrono::nanoseconds;
+	thread::latency_histogram histogram;
+	for (int i = 1; i <= 1000; ++i)
+		histogram.record(microseconds(i));
+	// negative durations count as zero.
+	histogram.record(nanoseconds(-5));
+
+	BOOST_CHECK_EQUAL(histogram.count(), 1001);
+	BOOST_CHECK(histogram.min() == nanoseconds(0));
+	BOOST_CHECK(histogram.max() == microseconds(1000));
+	BOOST_CHECK(histogram.mean() == nanoseconds(500500000 / 1001));
+
+	// percentiles are never below the exact value and at most 1/16 above it.
+	const auto check_percentile = [&](double percent, nanoseconds exact)
+	{
+		const auto value = histogram.percentile(percent);
+		BOOST_CHECK(value >= exact);
+		BOOST_CHECK(value <= exact + exact / 16);
+	};
+	check_percentile(50.0, microseconds(500));
+	check_percentile(90.0, microseconds(900));
+	check_percentile(99.0, microseconds(990));
+	BOOST_CHECK(histogram.percentile(100.0) == microseconds(1000));
+	BOOST_CHECK(histogram.percentile(0.0) == nanoseconds(0));
+
+	histogram.reset();
+	BOOST_CHECK_EQUAL(histogram.count(), 0);
+	histogram.record(nanoseconds(7));
+	BOOST_CHECK(histogram.percentile(50.0) == nanoseconds(7));
+	BOOST_CHECK(histogram.min() == nanoseconds(7));
+}
+
+BOOST_AUTO_TEST_CASE(test_task_statistics)
+{
+	using std::chrono::milliseconds;
+	thread::task_statistics statistics;
+	const auto dispatched = wall_clock::steady::now();
+	statistics.record(dispatched, dispatched + milliseconds(1),
+			dispatched + milliseconds(3), dispatched + milliseconds(10));
+	statistics.record(dispatched, dispatched + milliseconds(2),
+			dispatched + milliseconds(12), dispatched + milliseconds(10));
+
+	BOOST_CHECK_EQUAL(statistics.overruns.load(), 1);
+	BOOST_CHECK(statistics.work_duration.min() == milliseconds(2));
+	BOOST_CHECK(statistics.work_duration.max() == milliseconds(10));
+	BOOST_CHECK(statistics.dispatch_latency.max() == milliseconds(2));
+	BOOST_CHECK(statistics.lateness.max() == milliseconds(2));
+	BOOST_CHECK(statistics.lateness.min() == milliseconds(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,175 @@
+#include <flexcore/scheduler/cyclecontrol.hpp>
+#include <flexcore/scheduler/parallelscheduler.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace fc;
+
+namespace
+{
+/// region whose work tick blocks until it is released.
+struct blocking_region
+{
+	explicit blocking_region(const thread::overrun_policy& policy,
+			virtual_clock::duration tick_rate = thread::cycle_control::fast_tick)
+		: region(std::make_shared<parallel_region>("blocking", tick_rate))
+	{
+		region->set_overrun_policy(policy);
+		region->work_tick() >> [this]
+		{
+			while (blocked.load())
+				std::this_thread::yield();
+			++work;
+		};
+		region->optional_work_tick() >> [this]{ ++optional_work; };
+	}
+
+	std::shared_ptr<parallel_region> region;
+	std::atomic<bool> blocked{true};
+	std::atomic<int> work{0};
+	std::atomic<int> optional_work{0};
+};
+
+std::unique_ptr<thread::cycle_control> make_control(blocking_region& blocking)
+{
+	auto control = std::make_unique<thread::cycle_control>(
+			std::make_unique<thread::parallel_scheduler>(),
+			std::make_shared<thread::afap_main_loop>(false));
+	control->add_task(thread::periodic_task{blocking.region}, blocking.region->get_duration());
+	return control;
+}
+
+/// releases the region and waits for its current tick to be finished.
+void finish_tick(thread::cycle_control& control, blocking_region& blocking)
+{
+	blocking.blocked.store(false);
+	control.stop();
+	blocking.blocked.store(true);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_overrun)
+
+BOOST_AUTO_TEST_CASE(test_skip_tick)
+{
+	blocking_region blocking{thread::overrun_policy::skip_tick()};
+	auto control = make_control(blocking);
+
+	control->work();
+	control->work(); // first tick still running
+	finish_tick(*control, blocking);
+	BOOST_CHECK_EQUAL(blocking.work.load(), 1);
+
+	control->work();
+	finish_tick(*control, blocking);
+	BOOST_CHECK_EQUAL(blocking.work.load(), 2);
+
+	const auto& counters = control->region_overruns(*blocking.region);
+	BOOST_CHECK_EQUAL(counters.misses.load(), 1);
+	BOOST_CHECK_EQUAL(counters.skipped_ticks.load(), 1);
+	BOOST_CHECK_EQUAL(counters.escalations.load(), 0);
+	BOOST_CHECK(!control->last_exception());
+}
+
+BOOST_AUTO_TEST_CASE(test_run_when_done)
+{
+	blocking_region blocking{thread::overrun_policy::run_when_done(),
+		thread::cycle_control::medium_tick};
+	auto control = make_control(blocking);
+
+	// the region is due at tick 0 and tick 10.
+	for (int i = 0; i != 11; ++i)
+		control->work();
+	finish_tick(*control, blocking);
+	BOOST_CHECK_EQUAL(blocking.work.load(), 1);
+
+	// the missed tick starts in the next tick instead of waiting for tick 20.
+	control->work();
+	finish_tick(*control, blocking);
+	BOOST_CHECK_EQUAL(blocking.work.load(), 2);
+
+	const auto& counters = control->region_overruns(*blocking.region);
+	BOOST_CHECK_EQUAL(counters.misses.load(), 1);
+	BOOST_CHECK_EQUAL(counters.late_starts.load(), 1);
+	BOOST_CHECK(!control->last_exception());
+}
+
+BOOST_AUTO_TEST_CASE(test_run_when_done_waits_for_bucket)
+{
+	using thread::cycle_control;
+	blocking_region late{thread::overrun_policy::run_when_done(), cycle_control::medium_tick};
+	blocking_region other{thread::overrun_policy::skip_tick(), cycle_control::medium_tick};
+	auto control = make_control(late);
+	control->add_task(thread::periodic_task{other.region}, cycle_control::medium_tick);
+
+	for (int i = 0; i != 11; ++i)
+		control->work();
+	late.blocked.store(false);
+	while (late.work.load() != 1)
+		std::this_thread::yield();
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	// the other region with the same tick might share buffers with the late region.
+	control->work();
+	const auto& counters = control->region_overruns(*late.region);
+	BOOST_CHECK_EQUAL(counters.late_starts.load(), 0);
+
+	other.blocked.store(false);
+	control->stop();
+	control->work();
+	control->stop();
+	BOOST_CHECK_EQUAL(late.work.load(), 2);
+	BOOST_CHECK_EQUAL(counters.late_starts.load(), 1);
+	BOOST_CHECK(!control->last_exception());
+}
+
+BOOST_AUTO_TEST_CASE(test_shed_optional_work)
+{
+	blocking_region blocking{thread::overrun_policy::shed_optional_work()};
+	auto control = make_control(blocking);
+
+	control->work();
+	control->work();
+	finish_tick(*control, blocking);
+	BOOST_CHECK_EQUAL(blocking.optional_work.load(), 1);
+
+	// the tick after the overrun runs without optional work.
+	control->work();
+	finish_tick(*control, blocking);
+	BOOST_CHECK_EQUAL(blocking.work.load(), 2);
+	BOOST_CHECK_EQUAL(blocking.optional_work.load(), 1);
+
+	control->work();
+	finish_tick(*control, blocking);
+	BOOST_CHECK_EQUAL(blocking.work.load(), 3);
+	BOOST_CHECK_EQUAL(blocking.optional_work.load(), 2);
+
+	const auto& counters = control->region_overruns(*blocking.region);
+	BOOST_CHECK_EQUAL(counters.misses.load(), 1);
+	BOOST_CHECK_EQUAL(counters.shed_ticks.load(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_escalate)
+{
+	blocking_region blocking{thread::overrun_policy::escalate(3)};
+	auto control = make_control(blocking);
+
+	control->work();
+	control->work();
+	control->work();
+	BOOST_CHECK(!control->last_exception());
+	control->work(); // third consecutive miss calls the timeout callback
+	finish_tick(*control, blocking);
+
+	const auto& counters = control->region_overruns(*blocking.region);
+	BOOST_CHECK_EQUAL(counters.misses.load(), 3);
+	BOOST_CHECK_EQUAL(counters.skipped_ticks.load(), 2);
+	BOOST_CHECK_EQUAL(counters.escalations.load(), 1);
+	BOOST_CHECK(control->last_exception());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -9,7 +9,12 @@
 #include <flexcore/scheduler/parallelscheduler.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace fc;
 
@@ -127,4 +132,152 @@ BOOST_AUTO_TEST_CASE(test_main_loop)
 
 }
 
+BOOST_AUTO_TEST_CASE(test_queue_overflow)
+{
+	// more tasks than fit in the lock free queue end up in the overflow queue.
+	constexpr int nr_of_tasks{100};
+	std::atomic<int> counter{0};
+	{
+		thread::parallel_scheduler scheduler{4};
+		for (int i = 0; i != nr_of_tasks; ++i)
+			scheduler.add_task([&counter, ptr = std::make_unique<int>(1)] { counter += *ptr; });
+		while (counter.load() != nr_of_tasks)
+			std::this_thread::yield();
+		BOOST_CHECK_EQUAL(scheduler.nr_of_waiting_tasks(), 0);
+	}
+	BOOST_CHECK_EQUAL(counter.load(), nr_of_tasks);
+}
+
+BOOST_AUTO_TEST_CASE(test_earliest_deadline_first)
+{
+	using std::chrono::seconds;
+	BOOST_CHECK_EQUAL(thread::parallel_scheduler::yield(), 0);
+
+	struct shared_state
+	{
+		std::atomic<int> started{0};
+		std::atomic<bool> released{false};
+		std::atomic<bool> yielded{false};
+		std::atomic<int> finished{0};
+		std::mutex order_mutex{};
+		std::vector<int> order{};
+		std::vector<int> yielded_order{};
+		size_t nr_of_yielded = 0;
+	} state;
+	const auto record = [&state](int id)
+	{
+		return [&state, id]
+		{
+			std::lock_guard<std::mutex> lock(state.order_mutex);
+			state.order.push_back(id);
+			++state.finished;
+		};
+	};
+
+	thread::parallel_scheduler scheduler;
+	const int nr_of_workers = thread::parallel_scheduler::num_threads();
+	// keep all but one worker busy, such that only yield runs the deadline tasks.
+	for (int i = 1; i < nr_of_workers; ++i)
+	{
+		scheduler.add_task([&state]
+		{
+			++state.started;
+			while (!state.released.load())
+				std::this_thread::yield();
+		});
+	}
+
+	const auto now = wall_clock::steady::now();
+	thread::task_properties properties;
+	properties.deadline = now + seconds(3600);
+	scheduler.add_task([&, now]
+	{
+		++state.started;
+		while (state.started.load() != nr_of_workers)
+			std::this_thread::yield();
+		thread::task_properties p;
+		p.deadline = now + seconds(3);
+		scheduler.add_task(record(3), p);
+		p.deadline = now + seconds(1);
+		scheduler.add_task(record(1), p);
+		p.deadline = now + seconds(2);
+		scheduler.add_task(record(2), p);
+		// neither tasks with later deadlines nor tasks without deadline are run by yield.
+		p.deadline = now + seconds(7200);
+		scheduler.add_task(record(5), p);
+		scheduler.add_task(record(6));
+		state.nr_of_yielded = thread::parallel_scheduler::yield();
+		{
+			std::lock_guard<std::mutex> lock(state.order_mutex);
+			state.yielded_order = state.order;
+		}
+		state.yielded.store(true);
+	}, properties);
+
+	while (!state.yielded.load())
+		std::this_thread::yield();
+	BOOST_CHECK_EQUAL(state.nr_of_yielded, 3);
+	BOOST_CHECK((state.yielded_order == std::vector<int>{1, 2, 3}));
+
+	state.released.store(true);
+	while (state.finished.load() != 5)
+		std::this_thread::yield();
+	BOOST_CHECK_EQUAL(scheduler.nr_of_waiting_tasks(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_deadline_tasks_do_not_starve_others)
+{
+	struct shared_state
+	{
+		std::atomic<bool> other_done{false};
+		std::atomic<int> run_before{0};
+		std::atomic<int> chains{0};
+	} state;
+
+	thread::parallel_scheduler scheduler;
+	thread::task_properties properties;
+	properties.deadline = wall_clock::steady::now() + std::chrono::seconds(1);
+	const int limit = 100000;
+	// chains of deadline tasks, which add their successor until the other task ran.
+	std::function<void()> chain = [&]
+	{
+		if (state.other_done.load() || state.run_before.load() >= limit)
+		{
+			--state.chains;
+			return;
+		}
+		++state.run_before;
+		scheduler.add_task(chain, properties);
+	};
+	const int nr_of_chains = 4 * thread::parallel_scheduler::num_threads();
+	state.chains = nr_of_chains;
+	for (int i = 0; i != nr_of_chains; ++i)
+		scheduler.add_task(chain, properties);
+	scheduler.add_task([&state]{ state.other_done.store(true); });
+
+	while (state.chains.load() != 0)
+		std::this_thread::yield();
+	BOOST_CHECK(state.run_before.load()
+			< 10 * nr_of_chains * static_cast<int>(thread::parallel_scheduler::max_deadline_run));
+}
+
+BOOST_AUTO_TEST_CASE(test_bounded_queue)
+{
+	thread::detail::bounded_mpmc_queue<int> queue{4};
+	BOOST_CHECK_EQUAL(queue.capacity(), 4);
+	int value = 0;
+	BOOST_CHECK(!queue.try_pop(value));
+	for (int i = 1; i != 5; ++i)
+		BOOST_CHECK(queue.try_push(i));
+	int overflow = 5;
+	BOOST_CHECK(!queue.try_push(overflow));
+	for (int i = 1; i != 5; ++i)
+	{
+		BOOST_CHECK(queue.try_pop(value));
+		BOOST_CHECK_EQUAL(value, i);
+	}
+	BOOST_CHECK(!queue.try_pop(value));
+	BOOST_CHECK(queue.try_push(overflow));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
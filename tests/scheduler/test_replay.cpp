@@ -0,0 +1,136 @@
+#include <flexcore/scheduler/replay.hpp>
+#include <flexcore/scheduler/parallelscheduler.hpp>
+#include <flexcore/extended/nodes/recording.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace fc;
+
+namespace
+{
+using received_t = std::vector<std::pair<virtual_clock::steady::time_point, int>>;
+
+auto make_control(const std::shared_ptr<thread::main_loop>& loop)
+{
+	return std::make_unique<thread::cycle_control>(
+			std::make_unique<thread::parallel_scheduler>(),
+			[](auto& task){ return task.wait_until_done(thread::cycle_control::slow_tick); },
+			loop);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(test_replay)
+
+BOOST_AUTO_TEST_CASE(test_event_log_roundtrip)
+{
+	using time_point = virtual_clock::steady::time_point;
+	using std::chrono::milliseconds;
+	event_log log;
+	const int first = 42;
+	const double second = 0.5;
+	log.record(time_point{milliseconds(20)}, 1, &first, sizeof(first));
+	log.record(time_point{milliseconds(10)}, 2, &second, sizeof(second));
+	log.record(time_point{milliseconds(20)}, 3, nullptr, 0);
+
+	std::stringstream stream;
+	log.write(stream);
+	auto read = event_log::read(stream);
+	BOOST_CHECK_EQUAL(read.size(), 3);
+
+	// events are sorted by time, equal times keep their order.
+	const auto& entries = read.entries();
+	BOOST_CHECK_EQUAL(entries[0].channel, 2);
+	BOOST_CHECK(entries[0].time == time_point{milliseconds(10)});
+	BOOST_CHECK_EQUAL(entries[1].channel, 1);
+	BOOST_CHECK_EQUAL(entries[2].channel, 3);
+	BOOST_CHECK_EQUAL(entries[2].size, 0);
+
+	int restored = 0;
+	BOOST_REQUIRE_EQUAL(entries[1].size, sizeof(restored));
+	std::memcpy(&restored, read.payload(entries[1]), sizeof(restored));
+	BOOST_CHECK_EQUAL(restored, first);
+
+	std::stringstream garbage{"no event log"};
+	BOOST_CHECK_THROW(event_log::read(garbage), std::runtime_error);
+	std::stringstream truncated{stream.str().substr(0, stream.str().size() - 2)};
+	BOOST_CHECK_THROW(event_log::read(truncated), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_record_and_replay)
+{
+	event_log log;
+	received_t recorded;
+	{
+		auto control = make_control(std::make_shared<thread::afap_main_loop>());
+		control->add_task(thread::periodic_task{[]{}}, thread::cycle_control::medium_tick);
+		pure::event_source<int> external;
+		recording_tap<int> tap{log, 7, control->get_clock()};
+		external >> tap.in();
+		tap.out() >> [&](int value)
+		{
+			recorded.emplace_back(control->get_clock().steady_now(), value);
+		};
+
+		// inputs arrive between ticks, as if they came from another thread.
+		for (int tick = 0; tick != 300; ++tick)
+		{
+			if (tick % 37 == 5)
+				external.fire(tick);
+			control->work();
+			control->stop();
+		}
+	}
+	BOOST_CHECK_EQUAL(log.size(), 8);
+
+	std::stringstream file;
+	log.write(file);
+	auto loop = std::make_shared<thread::replay_main_loop>(event_log::read(file));
+	auto control = make_control(loop);
+	// events must not be injected while tasks, which are due in this tick, still run.
+	std::atomic<bool> task_running{false};
+	bool injected_while_running = false;
+	control->add_task(thread::periodic_task{[&]
+	{
+		task_running = true;
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+		task_running = false;
+	}}, thread::cycle_control::fast_tick);
+
+	std::mutex received_mutex;
+	received_t replayed;
+	event_log unused;
+	recording_tap<int> tap{unused, 7, control->get_clock()};
+	tap.out() >> [&](int value)
+	{
+		std::lock_guard<std::mutex> lock(received_mutex);
+		injected_while_running |= task_running.load();
+		replayed.emplace_back(virtual_clock::steady::now(), value);
+	};
+	replay_channel(*loop, tap);
+
+	control->start();
+	while (!loop->finished())
+		std::this_thread::yield();
+	control->stop();
+
+	BOOST_CHECK_EQUAL(unused.size(), 0);
+	std::lock_guard<std::mutex> lock(received_mutex);
+	BOOST_CHECK(!injected_while_running);
+	BOOST_REQUIRE_EQUAL(replayed.size(), recorded.size());
+	for (size_t i = 0; i != recorded.size(); ++i)
+	{
+		BOOST_CHECK(replayed[i].first == recorded[i].first);
+		BOOST_CHECK_EQUAL(replayed[i].second, recorded[i].second);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
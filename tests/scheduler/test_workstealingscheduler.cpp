@@ -0,0 +1,221 @@
+#include <flexcore/scheduler/cyclecontrol.hpp>
+#include <flexcore/scheduler/parallelscheduler.hpp>
+#include <flexcore/scheduler/workstealingscheduler.hpp>
+#include <flexcore/infrastructure.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include <sched.h>
+
+using namespace fc;
+
+BOOST_AUTO_TEST_SUITE(test_work_stealing_scheduler)
+
+BOOST_AUTO_TEST_CASE(test_all_tasks_are_executed)
+{
+	constexpr int nr_of_tasks{1000};
+	std::atomic<int> counter{0};
+	{
+		thread::work_stealing_scheduler scheduler{4};
+		BOOST_CHECK_EQUAL(scheduler.nr_of_threads(), 4);
+		for (int i = 0; i != nr_of_tasks; ++i)
+			scheduler.add_task([&counter]{ ++counter; });
+
+		while (counter.load() != nr_of_tasks)
+			std::this_thread::yield();
+		BOOST_CHECK_EQUAL(scheduler.nr_of_waiting_tasks(), 0);
+	}
+	BOOST_CHECK_EQUAL(counter.load(), nr_of_tasks);
+}
+
+BOOST_AUTO_TEST_CASE(test_tasks_added_by_tasks)
+{
+	constexpr int nr_of_children{100};
+	std::atomic<int> counter{0};
+	thread::work_stealing_scheduler scheduler{3};
+
+	// the children end up in the queue of a single worker and need to be stolen by the others.
+	scheduler.add_task([&]
+	{
+		for (int i = 0; i != nr_of_children; ++i)
+			scheduler.add_task([&counter]{ ++counter; });
+	});
+
+	while (counter.load() != nr_of_children)
+		std::this_thread::yield();
+	BOOST_CHECK_EQUAL(counter.load(), nr_of_children);
+}
+
+BOOST_AUTO_TEST_CASE(test_single_thread)
+{
+	std::atomic<int> counter{0};
+	thread::work_stealing_scheduler scheduler{1};
+	scheduler.add_task([&counter]{ ++counter; });
+	scheduler.add_task([&counter]{ ++counter; });
+	while (counter.load() != 2)
+		std::this_thread::yield();
+	scheduler.stop();
+	BOOST_CHECK_EQUAL(counter.load(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_with_cycle_control)
+{
+	std::atomic<int> counter{0};
+	thread::cycle_control control{std::make_unique<thread::work_stealing_scheduler>(2)};
+	for (int i = 0; i != 10; ++i)
+		control.add_task(thread::periodic_task{[&counter]{ ++counter; }},
+				thread::cycle_control::fast_tick);
+
+	control.work();
+	while (counter.load() != 10)
+		std::this_thread::yield();
+	BOOST_CHECK_EQUAL(control.nr_of_tasks(), 0);
+	BOOST_CHECK_EQUAL(counter.load(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_with_infrastructure)
+{
+	fc::infrastructure infra{std::make_unique<thread::work_stealing_scheduler>(2)};
+	auto region = infra.add_region("region", thread::cycle_control::fast_tick);
+	BOOST_CHECK(region != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_cpu_set_from_list)
+{
+	const auto cpus = thread::cpu_set::from_list("0-3,8,10-11\n");
+	BOOST_CHECK_EQUAL(cpus.size(), 7);
+	BOOST_CHECK(cpus.contains(2));
+	BOOST_CHECK(!cpus.contains(4));
+	BOOST_CHECK(cpus.contains(11));
+	BOOST_CHECK((thread::cpu_set{0, 8}.is_subset_of(cpus)));
+	BOOST_CHECK(!(thread::cpu_set{0, 9}.is_subset_of(cpus)));
+	BOOST_CHECK(thread::cpu_set::from_list("").empty());
+
+	BOOST_CHECK_THROW(thread::cpu_set::from_list("0-a"), std::invalid_argument);
+	BOOST_CHECK_THROW(thread::cpu_set::from_list("3-1"), std::invalid_argument);
+	BOOST_CHECK_THROW(thread::cpu_set::from_list("4096"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_pinned_tasks_run_on_their_cpus)
+{
+	const auto cpus = thread::cpu_set::single_cpus();
+	BOOST_REQUIRE(!cpus.empty());
+	const auto target = cpus.front();
+	const int target_cpu = static_cast<int>(target.to_vector().front());
+
+	constexpr int nr_of_tasks{100};
+	std::atomic<int> counter{0};
+	std::atomic<int> misplaced{0};
+	thread::work_stealing_scheduler scheduler{cpus};
+	BOOST_CHECK_EQUAL(scheduler.nr_of_threads(), cpus.size());
+	const thread::task_properties pinned{&target};
+	for (int i = 0; i != nr_of_tasks; ++i)
+	{
+		scheduler.add_task([&, target_cpu]
+		{
+			if (sched_getcpu() != target_cpu)
+				++misplaced;
+			++counter;
+		}, pinned);
+	}
+
+	while (counter.load() != nr_of_tasks)
+		std::this_thread::yield();
+	BOOST_CHECK_EQUAL(misplaced.load(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_pinned_tasks_without_matching_worker)
+{
+	// none of the workers is pinned, thus the task has to run anywhere.
+	std::atomic<int> counter{0};
+	const thread::cpu_set cpus{0};
+	thread::work_stealing_scheduler scheduler{2};
+	scheduler.add_task([&counter]{ ++counter; }, thread::task_properties{&cpus});
+	while (counter.load() != 1)
+		std::this_thread::yield();
+	BOOST_CHECK_EQUAL(counter.load(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_idle_workers_sleep_while_pinned_task_waits)
+{
+	const auto cpus = thread::cpu_set::single_cpus();
+	BOOST_REQUIRE(!cpus.empty());
+	// the second worker is not pinned, thus it may not run the pinned tasks.
+	thread::work_stealing_scheduler scheduler{{cpus.front(), thread::cpu_set{}}};
+	const thread::task_properties pinned{&cpus.front()};
+
+	std::promise<void> release;
+	auto released = release.get_future().share();
+	std::atomic<int> counter{0};
+	scheduler.add_task([released, &counter]{ ++counter; released.wait(); ++counter; }, pinned);
+	// the second task waits in the queue of the busy pinned worker.
+	while (counter.load() != 1)
+		std::this_thread::yield();
+	scheduler.add_task([&counter]{ ++counter; }, pinned);
+
+	// the idle worker would use the complete time spinning, if it did not sleep.
+	const auto begin = std::clock();
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	const auto cpu_ms = (std::clock() - begin) * 1000.0 / CLOCKS_PER_SEC;
+	release.set_value();
+
+	while (counter.load() != 3)
+		std::this_thread::yield();
+	BOOST_CHECK_LT(cpu_ms, 100.0);
+}
+
+BOOST_AUTO_TEST_CASE(test_region_affinity)
+{
+	const auto cpus = thread::cpu_set::single_cpus();
+	BOOST_REQUIRE(!cpus.empty());
+	fc::infrastructure infra{std::make_unique<thread::work_stealing_scheduler>(cpus)};
+	fc::region_options options;
+	options.cpus = cpus.front();
+	options.overrun = thread::overrun_policy::skip_tick();
+	auto region = infra.add_region("region", thread::cycle_control::fast_tick, options);
+	BOOST_CHECK(region->get_affinity() == cpus.front());
+	BOOST_CHECK(region->get_overrun_policy().action == thread::overrun_action::skip_tick);
+	BOOST_CHECK(infra.add_region("free", thread::cycle_control::fast_tick)->get_affinity().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_pinned_regions_need_affinity_support)
+{
+	thread::cycle_control control{std::make_unique<thread::parallel_scheduler>(),
+			std::make_shared<thread::afap_main_loop>()};
+	auto region = std::make_shared<parallel_region>("pinned", thread::cycle_control::fast_tick);
+	region->set_affinity(thread::cpu_set{0});
+	control.add_task(thread::periodic_task{region}, thread::cycle_control::fast_tick);
+	BOOST_CHECK_THROW(control.start(), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_build_local)
+{
+	const auto cpus = thread::cpu_set::single_cpus();
+	BOOST_REQUIRE(!cpus.empty());
+	auto region = std::make_shared<parallel_region>("local", thread::cycle_control::fast_tick);
+	region->set_affinity(cpus.back());
+
+	std::vector<char> data;
+	int cpu = -1;
+	region->build_local([&]
+	{
+		data.assign(1 << 20, 1);
+		cpu = sched_getcpu();
+	});
+	BOOST_CHECK(cpus.back().contains(static_cast<size_t>(cpu)));
+	const int node = thread::numa_node_of(cpus.back());
+	BOOST_CHECK_NE(node, -1);
+	BOOST_CHECK_EQUAL(thread::numa_node_of_address(data.data()), node);
+	BOOST_CHECK_EQUAL(thread::numa_node_of_address(&data.back()), node);
+
+	BOOST_CHECK_THROW(region->build_local([]{ throw std::runtime_error{"failed"}; }),
+			std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
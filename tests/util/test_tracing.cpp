@@ -0,0 +1,121 @@
+#include <flexcore/utils/tracing/tracing.hpp>
+#include <flexcore/infrastructure.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace fc;
+
+BOOST_AUTO_TEST_SUITE(test_tracing)
+
+BOOST_AUTO_TEST_CASE(test_spans_of_threads)
+{
+	trace::recorder recorder;
+	BOOST_CHECK(recorder.register_thread());
+	{
+		const trace::span outer{"outer", "test", recorder};
+		std::thread other{[&recorder]
+		{
+			recorder.register_thread();
+			const trace::span inner{"inner", "test", recorder};
+			recorder.record_instant("instant", "test");
+		}};
+		other.join();
+	}
+	BOOST_CHECK_EQUAL(recorder.size(), 3);
+
+	std::stringstream json;
+	recorder.write_chrome_json(json);
+	const auto trace = json.str();
+	BOOST_CHECK(trace.find("\"traceEvents\"") != std::string::npos);
+	BOOST_CHECK(trace.find("\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"X\"") != std::string::npos);
+	BOOST_CHECK(trace.find("\"name\":\"inner\"") != std::string::npos);
+	BOOST_CHECK(trace.find("\"name\":\"instant\",\"cat\":\"test\",\"ph\":\"i\"") != std::string::npos);
+	// both threads have their own ring.
+	BOOST_CHECK(trace.find("\"tid\":0") != std::string::npos);
+	BOOST_CHECK(trace.find("\"tid\":1") != std::string::npos);
+
+	// the ring of the exited thread is kept until its records are cleared.
+	BOOST_CHECK_EQUAL(recorder.nr_of_rings(), 2);
+	recorder.clear();
+	BOOST_CHECK_EQUAL(recorder.size(), 0);
+	BOOST_CHECK_EQUAL(recorder.nr_of_rings(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_unregistered_threads)
+{
+	trace::recorder recorder;
+	recorder.record_instant("dropped", "test");
+	BOOST_CHECK_EQUAL(recorder.size(), 0);
+	BOOST_CHECK_EQUAL(recorder.dropped(), 1);
+	BOOST_CHECK_EQUAL(recorder.nr_of_rings(), 0);
+
+	// rings without records are released as soon as their thread exits.
+	std::thread idle{[&recorder]{ recorder.register_thread(); }};
+	idle.join();
+	BOOST_CHECK_EQUAL(recorder.nr_of_rings(), 0);
+
+	recorder.clear();
+	BOOST_CHECK_EQUAL(recorder.dropped(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_ring_overwrites_oldest)
+{
+	trace::recorder recorder{4};
+	recorder.register_thread();
+	for (int i = 0; i != 6; ++i)
+		recorder.record(i < 2 ? "old" : "new", "test", i, i + 1);
+	BOOST_CHECK_EQUAL(recorder.size(), 4);
+
+	recorder.set_enabled(false);
+	recorder.record_instant("paused", "test");
+	recorder.set_enabled(true);
+
+	std::stringstream json;
+	recorder.write_chrome_json(json);
+	BOOST_CHECK(json.str().find("old") == std::string::npos);
+	BOOST_CHECK(json.str().find("paused") == std::string::npos);
+	BOOST_CHECK(json.str().find("\"ts\":0.005") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_interned_names)
+{
+	const auto* name = trace::recorder::intern("region \"a\"");
+	BOOST_CHECK_EQUAL(name, trace::recorder::intern(std::string{"region \"a\""}));
+
+	trace::recorder recorder;
+	recorder.register_thread();
+	recorder.record_instant(name, "test");
+	std::stringstream json;
+	recorder.write_chrome_json(json);
+	BOOST_CHECK(json.str().find("\"region \\\"a\\\"\"") != std::string::npos);
+}
+
+#ifdef FLEXCORE_ENABLE_TRACING
+BOOST_AUTO_TEST_CASE(test_traced_region)
+{
+	auto& recorder = trace::recorder::instance();
+	recorder.clear();
+	recorder.register_thread();
+	{
+		infrastructure infrastructure;
+		auto region = infrastructure.add_region("traced_region",
+				thread::cycle_control::fast_tick);
+		infrastructure.start_scheduler();
+		infrastructure.iterate_main_loop();
+		infrastructure.stop_scheduler();
+	}
+	std::stringstream json;
+	recorder.write_chrome_json(json);
+	const auto trace = json.str();
+	BOOST_CHECK(trace.find("\"traced_region\"") != std::string::npos);
+	BOOST_CHECK(trace.find("\"switch_tick\"") != std::string::npos);
+	BOOST_CHECK(trace.find("\"work_tick\"") != std::string::npos);
+	BOOST_CHECK(trace.find("\"enqueue\"") != std::string::npos);
+	BOOST_CHECK(trace.find("\"dequeue\"") != std::string::npos);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()